@@ -43,35 +43,174 @@ const char * Aperture::rs274x_name()
 }
 
 
+//
+// Compiles the expression trees into the program, one value per tree.
+//
+void MacroProgram::compile(const vector<NodeT *> &expressions)
+{
+	code.clear();
+	stackDepth = 0;
+	for (size_t i = 0; i < expressions.size(); i++)
+	{
+		emit(expressions[i], 1);
+		Instruction store = { STORE, 0, 0 };
+		code.push_back(store);
+	}
+	count = int(expressions.size());
+}
+
+//
+// Appends the postfix code of node, folding an operation whose operands are both constants.
+// A division by a constant zero is left for run() so the error is only reported if the value is used.
+//
+void MacroProgram::emit(const NodeT *node, int depth)
+{
+	if (depth > stackDepth)
+		stackDepth = depth;
+
+	Instruction in = { PUSH_CONSTANT, 0, 0 };
+	switch (node->type)
+	{
+	case NodeT::CONSTANT:
+		in.value = node->arg1.value;
+		code.push_back(in);
+		return;
+	case NodeT::VAR:
+		in.op = PUSH_VARIABLE;
+		in.varID = node->arg1.varID;
+		code.push_back(in);
+		return;
+	case NodeT::OPNEG:
+		emit(node->arg1.node, depth);
+		if (code.back().op == PUSH_CONSTANT)
+			code.back().value = -code.back().value;
+		else
+		{
+			in.op = OPNEG;
+			code.push_back(in);
+		}
+		return;
+	case NodeT::OPMUL:	in.op = OPMUL; break;
+	case NodeT::OPDIV:	in.op = OPDIV; break;
+	case NodeT::OPADD:	in.op = OPADD; break;
+	case NodeT::OPSUB:	in.op = OPSUB; break;
+	}
+
+	emit(node->arg1.node, depth);
+	size_t left = code.size() - 1;
+	emit(node->arg2.node, depth + 1);
+	if (code.size() - 1 == left + 1 && code[left].op == PUSH_CONSTANT && code.back().op == PUSH_CONSTANT
+		&& !(in.op == OPDIV && code.back().value == 0))
+	{
+		double a = code[left].value;
+		double b = code.back().value;
+		code.pop_back();
+		switch (in.op)
+		{
+		case OPMUL:	code.back().value = a * b; break;
+		case OPDIV:	code.back().value = a / b; break;
+		case OPADD:	code.back().value = a + b; break;
+		case OPSUB:	code.back().value = a - b; break;
+		default: break;
+		}
+	}
+	else
+		code.push_back(in);
+}
+
+//
+// Evaluates every expression. A value that cannot be evaluated is set to 0 and its error is recorded,
+// either -1 for a division by zero or n for an unassigned variable $n.
+//
+void MacroProgram::run(const vector<double> &variables, vector<double> &values, vector<int> &errors) const
+{
+	values.resize(count);
+	errors.resize(count);
+	vector<double> stack(stackDepth + 1);
+	int sp = 0;
+	int n = 0;
+	int error = 0;
+	for (size_t i = 0; i < code.size(); i++)
+	{
+		const Instruction &in = code[i];
+		switch (in.op)
+		{
+		case PUSH_CONSTANT:
+			stack[sp++] = in.value;
+			break;
+		case PUSH_VARIABLE:
+			if (in.varID < static_cast<int>(variables.size()))
+				stack[sp++] = variables[in.varID];
+			else
+			{
+				if (error == 0)
+					error = in.varID + 1;
+				stack[sp++] = 0;
+			}
+			break;
+		case OPNEG:	stack[sp-1] = -stack[sp-1]; break;
+		case OPMUL:	sp--; stack[sp-1] *= stack[sp]; break;
+		case OPADD:	sp--; stack[sp-1] += stack[sp]; break;
+		case OPSUB:	sp--; stack[sp-1] -= stack[sp]; break;
+		case OPDIV:
+			sp--;
+			if (stack[sp] == 0)
+			{
+				if (error == 0)
+					error = -1;
+				stack[sp-1] = 0;
+			}
+			else
+				stack[sp-1] /= stack[sp];
+			break;
+		case STORE:
+			values[n] = stack[--sp];
+			errors[n] = error;
+			error = 0;
+			n++;
+			break;
+		}
+	}
+}
+
+string MacroProgram::errorText(int error)
+{
+	ostringstream oss;
+	if (error < 0)
+		oss << "division by zero";
+	else
+		oss << "variable $" << error << " has not been assigned";
+	return oss.str();
+}
+
 //
 // Safely gets value from Aperture::modifier at element number idx
 //
 double Aperture::getParameter(int idx)
 {
-	ostringstream oss;
-	if (idx >= static_cast<int>(parameter.size())) // Исправлено сравнение типов
+	if (idx < 0 || idx >= static_cast<int>(parameterValues.size()))
 	{
+		ostringstream oss;
 		oss	<<"modifier expected at position "<<(idx+1);
 		throw oss.str();
 	}
-	try
+	if (parameterErrors[idx] != 0)
 	{
-		return parameter[idx]->evaluate();
-	}
-	catch (string msg)
-	{
-		oss <<msg<<" at parameter "<<idx+1;
+		ostringstream oss;
+		oss <<MacroProgram::errorText(parameterErrors[idx])<<" at parameter "<<idx+1;
 		throw oss.str();
 	}
-
+	return parameterValues[idx];
 }
 
 
 //------------------------------------------------------------
 // function for adding a new element to the link list of
 // Aperture objects.
-void Aperture::render(const double dots_per_unit, const double grow_size, int ADmodifierCount)
+void Aperture::render(const double dots_per_unit, const double grow_size, const std::vector<double> &modifiers, Arena &arena)
 {
+	int ADmodifierCount = int(modifiers.size());
+	parameter.run(modifiers, parameterValues, parameterErrors); // evaluate all modifiers of the primitive at once
 	double rotation = 0;
 	double standardHoleX = 0;
 	double standardHoleY = 0;
@@ -88,7 +227,7 @@ void Aperture::render(const double dots_per_unit, const double grow_size, int AD
 	case SPECIAL_CIRCLE :
 	{
 		double  ysize, xsize, x_center=0, y_center=0;
-		polygons.push_back(Polygon());		// Create instance of empty polygon
+		polygons.push_back(Polygon(arena));		// Create instance of empty polygon
 
 		if (primitive == STANDARD_CIRCLE)
 		{
@@ -143,7 +282,7 @@ void Aperture::render(const double dots_per_unit, const double grow_size, int AD
 	case STANDARD_RECTANGLE :
 	{
 		double y_size, x_size;
-		polygons.push_back(Polygon());		// Create instance of empty polygon
+		polygons.push_back(Polygon(arena));		// Create instance of empty polygon
 
 		y_size = x_size = getParameter(0) * dots_per_unit - 0.5  + grow_size;
 		// (RS274X  botch) If only 1 modifier given then assume square.
@@ -177,7 +316,7 @@ void Aperture::render(const double dots_per_unit, const double grow_size, int AD
 		int nsides;
 		double x_centre = 0;
 		double y_centre = 0;
-		polygons.push_back(Polygon());		// Create instance of empty polygon
+		polygons.push_back(Polygon(arena));		// Create instance of empty polygon
 
 		if ( primitive == STANDARD_POLYGON)
 		{
@@ -235,7 +374,7 @@ void Aperture::render(const double dots_per_unit, const double grow_size, int AD
 		double theta = rotation;
 		for (int i=0; i < 4; i++)
 		{
-			polygons.push_back(Polygon());		// Create instance of empty polygon
+			polygons.push_back(Polygon(arena));		// Create instance of empty polygon
 		    polygons.back().vdata->addArc( theta + argout, theta+(M_PI/2 - argout), outside_radius, x_centre, y_centre, false);
 		    polygons.back().vdata->addArc( theta + ( M_PI/2 - argin), theta + argin, inside_radius, x_centre, y_centre, true);
 		    theta += M_PI/2;
@@ -263,7 +402,7 @@ void Aperture::render(const double dots_per_unit, const double grow_size, int AD
 
 		double rectangle_length, rectangle_height, theta;
 		Point start, end, centre;
-		polygons.push_back(Polygon());		// Create instance of empty polygon
+		polygons.push_back(Polygon(arena));		// Create instance of empty polygon
 
 		if (getParameter(0) == 1) {	polygons.back().polarity = CLEAR; }
 
@@ -324,16 +463,16 @@ void Aperture::render(const double dots_per_unit, const double grow_size, int AD
 	// ******************************************************************************
 	case SPECIAL_OUTLINE :
 	{
-		polygons.push_back(Polygon());		// Create instance of empty polygon
+		polygons.push_back(Polygon(arena));		// Create instance of empty polygon
 		if (getParameter(0) == 1) {	polygons.back().polarity = CLEAR; }
 
 		int num_points		= int ( getParameter(1) );
 
 		// rotation radians (+ = counterclockwise, - = clockwise)
 		// last parameter is always specifies rotation regardless of number of surplus vertices.
-		rotation = parameter.back()->evaluate() * M_PI / 180.0;
+		rotation = getParameter(parameter.size() - 1) * M_PI / 180.0;
 
-		if (num_points*2 + 3 > static_cast<int>(parameter.size())) // Исправлено сравнение типов
+		if (num_points*2 + 3 > parameter.size())
 			throw string("specified number of points exceeds number of vertices listed");
 
 		for (int i=0; i < num_points; i++ )
@@ -368,16 +507,16 @@ void Aperture::render(const double dots_per_unit, const double grow_size, int AD
 		{
 		    if (diameter < 1) break;
 		    UPLIMIT(thickenss, diameter/2);
-			polygons.push_back(Polygon());		// Create instance of empty polygon
+			polygons.push_back(Polygon(arena));		// Create instance of empty polygon
 		    polygons.back().vdata->addArc( 0, 2*M_PI, diameter/2, x_centre, y_centre, false);
 		    polygons.back().vdata->addArc( 2*M_PI, 0, diameter/2 - thickenss, x_centre, y_centre, true);
 		    polygons.back().vdata->rotate(rotation);
 		    diameter -= 2*(thickenss + gap);
 		}
-		polygons.push_back(Polygon());
+		polygons.push_back(Polygon(arena));
 	    polygons.back().vdata->addRectangle(hair_thickness, hair_length, x_centre, y_centre);
 	    polygons.back().vdata->rotate(rotation);
-		polygons.push_back(Polygon());
+		polygons.push_back(Polygon(arena));
 	    polygons.back().vdata->addRectangle(hair_length, hair_thickness, x_centre, y_centre);
 	    polygons.back().vdata->rotate(rotation);
 		break;
@@ -395,7 +534,7 @@ void Aperture::render(const double dots_per_unit, const double grow_size, int AD
 	// then add a hole by adding one final clear circle or rectangle polygon to end of the list.
 	if ( standardHoleX > 0.5 )
 	{
-		polygons.push_back(Polygon());
+		polygons.push_back(Polygon(arena));
 		polygons.back().polarity = CLEAR;
 		if ( standardHoleY > 0.5 )
 			polygons.back().vdata->addRectangle(standardHoleX, standardHoleY);
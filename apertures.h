@@ -7,6 +7,7 @@
 #include <map>
 #include <sstream>
 #include <list>
+#include <vector>
 
 
 
@@ -76,6 +77,37 @@ public:
 	}
 };
 
+
+/*
+ * MacroProgram holds the modifier expressions of an aperture macro primitive, compiled from NodeT trees
+ * into one stack machine program when the AM block is parsed. Subexpressions without variables are folded
+ * to constants at that time, so instantiating the macro in an AD block runs a single flat loop.
+ */
+class MacroProgram
+{
+private:
+	enum OpCode { PUSH_CONSTANT, PUSH_VARIABLE, OPMUL, OPDIV, OPADD, OPSUB, OPNEG, STORE };
+	struct Instruction
+	{
+		OpCode op;
+		int varID;			// PUSH_VARIABLE
+		double value;		// PUSH_CONSTANT
+	};
+	std::vector<Instruction> code;
+	int count;				// number of expressions, one STORE each
+	int stackDepth;			// stack size needed by run()
+
+	void emit(const NodeT *node, int depth);
+
+public:
+	MacroProgram() : count(0), stackDepth(0) { }
+
+	int size() const { return count; }
+	void compile(const std::vector<NodeT *> &expressions);
+	void run(const std::vector<double> &variables, std::vector<double> &values, std::vector<int> &errors) const;
+	static std::string errorText(int error);
+};
+
 class Gerber;
 
 // abstract class; defines base members for an aperture object.
@@ -110,20 +142,24 @@ class Aperture
 		double standardApHeight;				//  used to determine track width when linear and arc drawing plotting
 
 
-		std::vector< NodeT  * > parameter;
+		MacroProgram parameter;					// modifier expressions of the primitive
+		std::vector<double> parameterValues;	// modifiers evaluated by render() for the current AD block
+		std::vector<int> parameterErrors;		// MacroProgram::run() error of each value, 0 if none
 
         int   		DCode;
         std::string nameMacro;
-        std::list<Polygon> 	polygons;			// A list of polygons that making up this aperture. Created by member render()
+        std::vector<Polygon> 	polygons;			// A list of polygons that making up this aperture. Created by member render()
+        const Shape *shape;						// polygons of the aperture and its composites, built on the first flash
 
         double getParameter(int index);
-		void render(const double dots_per_unit, const double grow_size, int ADmodifierCount );
+		void render(const double dots_per_unit, const double grow_size, const std::vector<double> &modifiers, Arena &arena );
 
         Aperture()
         {
         	standardApWidth = 0;
         	standardApHeight = 0;
             composite = 0;
+            shape = 0;
             primitive = PRIMITIVE_INVALID;
             DCode = -1;
         }
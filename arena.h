@@ -0,0 +1,111 @@
+// This file is distributed under the terms of the GNU General Public License v3.
+
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/*
+ * Arena is a monotonic allocator owning the objects built while parsing one Gerber file.
+ *
+ * Objects are carved out of large blocks and are never freed one by one: the blocks are released together
+ * when the arena is destroyed. Objects with a destructor are recorded when created and destroyed at that
+ * time, newest first; trivially destructible objects cost nothing to release.
+ */
+class Arena
+{
+private:
+	struct Block
+	{
+		Block *next;
+	};
+	struct Cleanup
+	{
+		Cleanup *next;
+		void (*destroy)(void *);
+		void *object;
+	};
+
+	Block *blocks;
+	char *cursor;			// next free byte in the current block
+	char *limit;			// end of the current block
+	Cleanup *cleanups;		// objects to destroy on release, newest first
+	size_t blockSize;		// size of the next block, doubles up to maxBlockSize
+	enum { firstBlockSize = 16 * 1024, maxBlockSize = 1024 * 1024 };
+
+	Arena(const Arena &);				// not copyable
+	Arena &operator=(const Arena &);
+
+	template <class T>
+	static void destroy(void *object) { static_cast<T *>(object)->~T(); }
+
+	void *grow(size_t size, size_t align)
+	{
+		size_t bytes = sizeof(Block) + size + align;
+		if (bytes < blockSize)
+			bytes = blockSize;
+		Block *block = (Block *)malloc(bytes);
+		if (block == 0)
+			throw std::bad_alloc();
+		block->next = blocks;
+		blocks = block;
+		cursor = (char *)(block + 1);
+		limit = (char *)block + bytes;
+		if (blockSize < maxBlockSize)
+			blockSize *= 2;
+		return allocate(size, align);
+	}
+
+public:
+	Arena() : blocks(0), cursor(0), limit(0), cleanups(0), blockSize(firstBlockSize) { }
+	~Arena() { release(); }
+
+	// Returns uninitialised memory for size bytes, aligned to align (a power of two).
+	void *allocate(size_t size, size_t align = alignof(max_align_t))
+	{
+		size_t pad = (align - ((uintptr_t)cursor & (align - 1))) & (align - 1);
+		if (size + pad > size_t(limit - cursor))
+			return grow(size, align);
+		char *p = cursor + pad;
+		cursor = p + size;
+		return p;
+	}
+
+	// Constructs a T in the arena. It lives until the arena is released.
+	template <class T, class... Args>
+	T *create(Args &&...args)
+	{
+		if (std::is_trivially_destructible<T>::value)
+			return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+
+		Cleanup *cleanup = (Cleanup *)allocate(sizeof(Cleanup), alignof(Cleanup));
+		T *object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+		cleanup->destroy = &destroy<T>;
+		cleanup->object = object;
+		cleanup->next = cleanups;
+		cleanups = cleanup;
+		return object;
+	}
+
+	// Destroys every object and frees all blocks. The arena can be used again afterwards.
+	void release()
+	{
+		for (; cleanups; cleanups = cleanups->next)
+			cleanups->destroy(cleanups->object);
+		while (blocks)
+		{
+			Block *next = blocks->next;
+			free(blocks);
+			blocks = next;
+		}
+		cursor = limit = 0;
+		blockSize = firstBlockSize;
+	}
+};
+
+#endif // ARENA_H_
@@ -0,0 +1,228 @@
+// This file is distributed under the terms of the GNU General Public License v3.
+
+#include <string.h>
+#include <algorithm>
+
+#include "ccitt.h"
+
+struct Code
+{
+	unsigned short code;
+	unsigned char length;
+};
+
+// ITU-T T.4 Modified Huffman codes: terminating codes for runs 0 to 63, makeup codes for runs 64 to 1728, then
+// the extended makeup codes for runs 1792 to 2560 shared by both colours
+static const Code whiteCodes[] = {
+	{0x035, 8}, {0x007, 6}, {0x007, 4}, {0x008, 4}, {0x00b, 4}, {0x00c, 4}, {0x00e, 4}, {0x00f, 4}, {0x013, 5},
+	{0x014, 5}, {0x007, 5}, {0x008, 5}, {0x008, 6}, {0x003, 6}, {0x034, 6}, {0x035, 6}, {0x02a, 6}, {0x02b, 6},
+	{0x027, 7}, {0x00c, 7}, {0x008, 7}, {0x017, 7}, {0x003, 7}, {0x004, 7}, {0x028, 7}, {0x02b, 7}, {0x013, 7},
+	{0x024, 7}, {0x018, 7}, {0x002, 8}, {0x003, 8}, {0x01a, 8}, {0x01b, 8}, {0x012, 8}, {0x013, 8}, {0x014, 8},
+	{0x015, 8}, {0x016, 8}, {0x017, 8}, {0x028, 8}, {0x029, 8}, {0x02a, 8}, {0x02b, 8}, {0x02c, 8}, {0x02d, 8},
+	{0x004, 8}, {0x005, 8}, {0x00a, 8}, {0x00b, 8}, {0x052, 8}, {0x053, 8}, {0x054, 8}, {0x055, 8}, {0x024, 8},
+	{0x025, 8}, {0x058, 8}, {0x059, 8}, {0x05a, 8}, {0x05b, 8}, {0x04a, 8}, {0x04b, 8}, {0x032, 8}, {0x033, 8},
+	{0x034, 8}, {0x01b, 5}, {0x012, 5}, {0x017, 6}, {0x037, 7}, {0x036, 8}, {0x037, 8}, {0x064, 8}, {0x065, 8},
+	{0x068, 8}, {0x067, 8}, {0x0cc, 9}, {0x0cd, 9}, {0x0d2, 9}, {0x0d3, 9}, {0x0d4, 9}, {0x0d5, 9}, {0x0d6, 9},
+	{0x0d7, 9}, {0x0d8, 9}, {0x0d9, 9}, {0x0da, 9}, {0x0db, 9}, {0x098, 9}, {0x099, 9}, {0x09a, 9}, {0x018, 6},
+	{0x09b, 9}, {0x008, 11}, {0x00c, 11}, {0x00d, 11}, {0x012, 12}, {0x013, 12}, {0x014, 12}, {0x015, 12},
+	{0x016, 12}, {0x017, 12}, {0x01c, 12}, {0x01d, 12}, {0x01e, 12}, {0x01f, 12}
+};
+
+static const Code blackCodes[] = {
+	{0x037, 10}, {0x002, 3}, {0x003, 2}, {0x002, 2}, {0x003, 3}, {0x003, 4}, {0x002, 4}, {0x003, 5}, {0x005, 6},
+	{0x004, 6}, {0x004, 7}, {0x005, 7}, {0x007, 7}, {0x004, 8}, {0x007, 8}, {0x018, 9}, {0x017, 10}, {0x018, 10},
+	{0x008, 10}, {0x067, 11}, {0x068, 11}, {0x06c, 11}, {0x037, 11}, {0x028, 11}, {0x017, 11}, {0x018, 11},
+	{0x0ca, 12}, {0x0cb, 12}, {0x0cc, 12}, {0x0cd, 12}, {0x068, 12}, {0x069, 12}, {0x06a, 12}, {0x06b, 12},
+	{0x0d2, 12}, {0x0d3, 12}, {0x0d4, 12}, {0x0d5, 12}, {0x0d6, 12}, {0x0d7, 12}, {0x06c, 12}, {0x06d, 12},
+	{0x0da, 12}, {0x0db, 12}, {0x054, 12}, {0x055, 12}, {0x056, 12}, {0x057, 12}, {0x064, 12}, {0x065, 12},
+	{0x052, 12}, {0x053, 12}, {0x024, 12}, {0x037, 12}, {0x038, 12}, {0x027, 12}, {0x028, 12}, {0x058, 12},
+	{0x059, 12}, {0x02b, 12}, {0x02c, 12}, {0x05a, 12}, {0x066, 12}, {0x067, 12}, {0x00f, 10}, {0x0c8, 12},
+	{0x0c9, 12}, {0x05b, 12}, {0x033, 12}, {0x034, 12}, {0x035, 12}, {0x06c, 13}, {0x06d, 13}, {0x04a, 13},
+	{0x04b, 13}, {0x04c, 13}, {0x04d, 13}, {0x072, 13}, {0x073, 13}, {0x074, 13}, {0x075, 13}, {0x076, 13},
+	{0x077, 13}, {0x052, 13}, {0x053, 13}, {0x054, 13}, {0x055, 13}, {0x05a, 13}, {0x05b, 13}, {0x064, 13},
+	{0x065, 13}, {0x008, 11}, {0x00c, 11}, {0x00d, 11}, {0x012, 12}, {0x013, 12}, {0x014, 12}, {0x015, 12},
+	{0x016, 12}, {0x017, 12}, {0x01c, 12}, {0x01d, 12}, {0x01e, 12}, {0x01f, 12}
+};
+
+// Group 4 mode codes, vertical ones for a1 from 3 pixels right of b1 to 3 pixels left of it
+static const Code passCode = {0x1, 4};
+static const Code horizontalCode = {0x1, 3};
+static const Code verticalCodes[] = { {0x03, 7}, {0x03, 6}, {0x3, 3}, {0x1, 1}, {0x2, 3}, {0x02, 6}, {0x02, 7} };
+static const Code eolCode = {0x001, 12};
+
+void CcittEncoder::put(unsigned code, int length)
+{
+	bits = (bits << length) | code;
+	bitCount += length;
+	while (bitCount >= 8)
+	{
+		bitCount -= 8;
+		data.push_back((unsigned char)(bits >> bitCount));
+	}
+}
+
+// writes a run the way libtiff does: 2560 makeup codes while more than 2623 are left, then one makeup code and
+// a terminating code
+void CcittEncoder::putRun(unsigned run, bool isBlack)
+{
+	const Code *codes = isBlack ? blackCodes : whiteCodes;
+	for (; run >= 2624; run -= 2560)
+		put(codes[63 + (2560 >> 6)].code, codes[63 + (2560 >> 6)].length);
+	if (run >= 64)
+	{
+		put(codes[63 + (run >> 6)].code, codes[63 + (run >> 6)].length);
+		run &= 63;
+	}
+	put(codes[run].code, codes[run].length);
+}
+
+// pads the last bits to a whole byte
+void CcittEncoder::flush()
+{
+	if (bitCount)
+	{
+		data.push_back((unsigned char)(bits << (8 - bitCount)));
+		bitCount = 0;
+	}
+}
+
+// number of pixels of one colour from pixel x of the row, stopping at pixel end
+static unsigned runLength(const unsigned char *row, unsigned x, unsigned end, bool isBlack)
+{
+	unsigned flip = isBlack ? 0xff : 0x00;		// makes the pixels of the run zero
+	unsigned start = x;
+
+	if (x & 7)		// rest of the first byte
+	{
+		unsigned byte = ((row[x >> 3] ^ flip) << (x & 7)) & 0xff;
+		if (byte)
+			return std::min(x + __builtin_clz(byte) - 24, end) - start;
+		x = (x | 7) + 1;
+	}
+	uint64_t flip64 = isBlack ? ~uint64_t(0) : 0;
+	for (uint64_t word; x + 64 <= end; x += 64)	// 64 pixels at a time through long runs
+	{
+		memcpy(&word, row + (x >> 3), sizeof(word));
+		if (word != flip64)
+			break;
+	}
+	for (; x < end; x += 8)
+	{
+		unsigned byte = row[x >> 3] ^ flip;
+		if (byte)
+		{
+			x += __builtin_clz(byte) - 24;
+			break;
+		}
+	}
+	return std::min(x, end) - start;
+}
+
+//
+// Encodes one row: white and black runs in turn up to each changing pixel, starting with a white one that can be
+// empty, and padded to a whole byte.
+//
+void CcittEncoder::encode1D(const int *changes, size_t count, int width)
+{
+	int x = 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		putRun(changes[i] - x, i & 1);
+		x = changes[i];
+	}
+	putRun(width - x, count & 1);
+	flush();
+}
+
+//
+// Encodes one row a[] against the reference row b[] above it, following the changing elements a0, a1, a2 of the
+// row and b1, b2 of the reference row through pass, vertical and horizontal modes as libtiff does. a0 starts on
+// an imaginary white pixel left of the row, so changes at x = 0 count as coming after it.
+//
+void CcittEncoder::encode2D(const int *a, size_t aCount, const int *b, size_t bCount, int width)
+{
+	int a0 = 0;
+	bool isBlack = false;		// colour of a0
+	size_t i = 0, j = 0;		// first changes after a0 of the row and the reference row
+	for (;;)
+	{
+		int a1 = i < aCount ? a[i] : width;
+		size_t k = j + ((j & 1) != isBlack);	// b1 turns to the other colour than a0, even changes to black
+		int b1 = k < bCount ? b[k] : width;
+		int b2 = k + 1 < bCount ? b[k + 1] : width;
+		if (b2 < a1)
+		{
+			put(passCode.code, passCode.length);
+			a0 = b2;
+		}
+		else if (b1 - a1 >= -3 && b1 - a1 <= 3)
+		{
+			const Code &code = verticalCodes[b1 - a1 + 3];
+			put(code.code, code.length);
+			a0 = a1;
+			isBlack = !isBlack;
+		}
+		else
+		{
+			int a2 = i + 1 < aCount ? a[i + 1] : width;
+			put(horizontalCode.code, horizontalCode.length);
+			putRun(a1 - a0, isBlack);
+			putRun(a2 - a1, !isBlack);
+			a0 = a2;
+		}
+		if (a0 >= width)
+			break;
+		while (i < aCount && a[i] <= a0)
+			i++;
+		while (j < bCount && b[j] <= a0)
+			j++;
+	}
+}
+
+void CcittEncoder::clear()
+{
+	data.clear();
+	reference.clear();
+}
+
+void CcittEncoder::encodeRow(const int *changes, size_t count, unsigned width)
+{
+	if (!isG4)
+	{
+		encode1D(changes, count, int(width));
+		return;
+	}
+	encode2D(changes, count, reference.data(), reference.size(), int(width));
+	reference.assign(changes, changes + count);
+}
+
+void CcittEncoder::endStrip()
+{
+	if (isG4)
+	{
+		put(eolCode.code, eolCode.length);		// EOFB
+		put(eolCode.code, eolCode.length);
+		flush();
+	}
+}
+
+void CcittEncoder::encodeRows(const unsigned char *bitmap, unsigned width, unsigned rows, size_t bytesPerRow)
+{
+	reference.clear();
+	for (unsigned y = 0; y < rows; y++, bitmap += bytesPerRow)
+	{
+		// changing pixels of the row, found a byte or more at a time
+		changes.clear();
+		for (unsigned x = 0; (x += runLength(bitmap, x, width, changes.size() & 1)) < width;)
+			changes.push_back(int(x));
+
+		if (!isG4)
+			encode1D(changes.data(), changes.size(), int(width));
+		else
+		{
+			encode2D(changes.data(), changes.size(), reference.data(), reference.size(), int(width));
+			reference.swap(changes);
+		}
+	}
+	endStrip();
+}
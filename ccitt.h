@@ -0,0 +1,48 @@
+// This file is distributed under the terms of the GNU General Public License v3.
+
+#ifndef CCITT_H_
+#define CCITT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/*
+ * CcittEncoder compresses monochrome strips for TIFF compression CCITTRLE, CCITT Group 3 1-Dimensional Modified
+ * Huffman run length encoding with every row starting on a byte boundary, or CCITTFAX4, CCITT Group 4 2-Dimensional
+ * encoding ended by EOFB.
+ *
+ * The bytes are the same as libtiff produces with TIFFWriteEncodedStrip(), so strips can be compressed on any
+ * thread and written with TIFFWriteRawStrip(). Pixels are bits, most significant first, 1 for black.
+ */
+class CcittEncoder
+{
+private:
+	bool isG4;
+	uint64_t bits;				// bits not yet stored in data, the last ones in the lowest bits
+	int bitCount;
+	std::vector<int> changes;			// changing pixels of the row being encoded from a bitmap
+	std::vector<int> reference;			// changing pixels of the row above, none above the first row of a strip
+
+	void put(unsigned code, int length);
+	void putRun(unsigned run, bool isBlack);
+	void flush();
+	void encode1D(const int *changes, size_t count, int width);
+	void encode2D(const int *a, size_t aCount, const int *b, size_t bCount, int width);
+
+public:
+	std::vector<unsigned char> data;	// encoded strip
+
+	explicit CcittEncoder(bool isG4 = false) : isG4(isG4), bits(0), bitCount(0) { }
+
+	void clear();						// starts the next strip, keeping the memory
+	void encodeRows(const unsigned char *bitmap, unsigned width, unsigned rows, size_t bytesPerRow);
+
+	// Encodes the next row of the strip from its changing pixels: the increasing x coordinates of the pixels whose
+	// colour differs from the pixel on their left, the row starting white. The strip is ended by endStrip(), so
+	// the rows never need to be drawn on a bitmap.
+	void encodeRow(const int *changes, size_t count, unsigned width);
+	void endStrip();
+};
+
+#endif // CCITT_H_
@@ -0,0 +1,159 @@
+// This file is distributed under the terms of the GNU General Public License v3.
+
+#include <string.h>
+#include <string>
+#include <vector>
+#include <tiffio.h>
+#include <zlib.h>
+#include <zstd.h>
+extern "C" {
+#include <jbig85.h>
+}
+
+#include "compression.h"
+
+const char *codecNames = "ccitt-rle, ccitt-g4, packbits, deflate, zstd, jbig";
+
+static const struct
+{
+	const char *name;
+	Codec_t codec;
+	unsigned short tiffCompression;
+} codecs[] = {
+	{"ccitt-rle", CODEC_CCITT_RLE, COMPRESSION_CCITTRLE},
+	{"ccitt-g4", CODEC_CCITT_G4, COMPRESSION_CCITTFAX4},
+	{"packbits", CODEC_PACKBITS, COMPRESSION_PACKBITS},
+	{"deflate", CODEC_DEFLATE, COMPRESSION_ADOBE_DEFLATE},
+	{"zstd", CODEC_ZSTD, COMPRESSION_ZSTD},
+	{"jbig", CODEC_JBIG, COMPRESSION_JBIG}};
+
+bool findCodec(const std::string &name, Codec_t &codec)
+{
+	for (size_t i = 0; i < sizeof(codecs) / sizeof(codecs[0]); i++)
+		if (name == codecs[i].name)
+		{
+			codec = codecs[i].codec;
+			return true;
+		}
+	return false;
+}
+
+unsigned short tiffCompression(Codec_t codec)
+{
+	return codecs[codec].tiffCompression;
+}
+
+// PackBits of one row, which runs must not cross: runs of three or more bytes, the rest as literals
+void StripEncoder::packBits(const unsigned char *row, size_t bytes)
+{
+	for (size_t i = 0; i < bytes;)
+	{
+		size_t run = 1;
+		while (i + run < bytes && run < 128 && row[i + run] == row[i])
+			run++;
+		if (run >= 3)
+		{
+			buffer.push_back((unsigned char)(1 - int(run)));
+			buffer.push_back(row[i]);
+			i += run;
+			continue;
+		}
+
+		size_t end = i + 1;
+		while (end < bytes && end - i < 128 && !(end + 2 < bytes && row[end] == row[end + 1] && row[end] == row[end + 2]))
+			end++;
+		buffer.push_back((unsigned char)(end - i - 1));
+		buffer.insert(buffer.end(), row + i, row + end);
+		i = end;
+	}
+}
+
+void StripEncoder::encode(const unsigned char *bitmap, unsigned width, unsigned rows, size_t bytesPerRow)
+{
+	size_t bytes = bytesPerRow * rows;
+	switch (codec)
+	{
+	case CODEC_CCITT_RLE:
+	case CODEC_CCITT_G4:
+		ccitt.clear();
+		ccitt.encodeRows(bitmap, width, rows, bytesPerRow);
+		break;
+
+	case CODEC_PACKBITS:
+		buffer.clear();
+		for (unsigned y = 0; y < rows; y++)
+			packBits(bitmap + y * bytesPerRow, bytesPerRow);
+		break;
+
+	case CODEC_DEFLATE:
+	{
+		uLongf length = compressBound(uLong(bytes));
+		buffer.resize(length);
+		if (compress2(buffer.data(), &length, bitmap, uLong(bytes), Z_DEFAULT_COMPRESSION) != Z_OK)
+			throw std::string("deflate compression failed");
+		buffer.resize(length);
+		break;
+	}
+
+	case CODEC_ZSTD:
+	{
+		buffer.resize(ZSTD_compressBound(bytes));
+		size_t length = ZSTD_compress(buffer.data(), buffer.size(), bitmap, bytes, 9); // libtiff's default level
+		if (ZSTD_isError(length))
+			throw std::string("zstd compression failed: ") + ZSTD_getErrorName(length);
+		buffer.resize(length);
+		break;
+	}
+
+	case CODEC_JBIG:
+		throw std::string("JBIG images are compressed as a whole");
+	}
+}
+
+JbigEncoder::JbigEncoder(unsigned width, unsigned height)
+	: state(new jbg85_enc_state), bytesPerRow((width + 7) / 8), rows(3 * bytesPerRow), rowCount(0)
+{
+	jbg85_enc_init((jbg85_enc_state *)state, width, height, output, this);
+	jbg85_enc_options((jbg85_enc_state *)state, -1, 0, 0); // no adaptive template search, which is slow on wide images
+}
+
+JbigEncoder::~JbigEncoder()
+{
+	delete (jbg85_enc_state *)state;
+}
+
+// libtiff stores JBIG data with the bits of each byte reversed, as if the fill order were LSB to MSB
+void JbigEncoder::output(unsigned char *start, size_t length, void *encoder)
+{
+	static const struct Reversed
+	{
+		unsigned char bits[256];
+		Reversed()
+		{
+			for (int i = 0; i < 256; i++)
+			{
+				bits[i] = 0;
+				for (int b = 0; b < 8; b++)
+					if (i & (1 << b))
+						bits[i] |= 0x80 >> b;
+			}
+		}
+	} reversed;
+
+	std::vector<unsigned char> &data = ((JbigEncoder *)encoder)->data;
+	for (size_t i = 0; i < length; i++)
+		data.push_back(reversed.bits[start[i]]);
+}
+
+// Adds the next rows of the image. Each row is copied, so the encoder can look back at it in the next strip.
+void JbigEncoder::encode(const unsigned char *bitmap, unsigned count, size_t bitmapBytesPerRow)
+{
+	for (unsigned y = 0; y < count; y++, rowCount++)
+	{
+		unsigned char *row = &rows[rowCount % 3 * bytesPerRow];
+		memcpy(row, bitmap + y * bitmapBytesPerRow, bytesPerRow);
+		unsigned char *previous = rowCount >= 1 ? &rows[(rowCount - 1) % 3 * bytesPerRow] : 0;
+		unsigned char *beforePrevious = rowCount >= 2 ? &rows[(rowCount - 2) % 3 * bytesPerRow] : 0;
+		jbg85_enc_lineout((jbg85_enc_state *)state, row, previous, beforePrevious);
+	}
+}
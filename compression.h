@@ -0,0 +1,75 @@
+// This file is distributed under the terms of the GNU General Public License v3.
+
+#ifndef COMPRESSION_H_
+#define COMPRESSION_H_
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+#include "ccitt.h"
+
+/*  TIFF compressions of the output image */
+typedef enum {CODEC_CCITT_RLE, CODEC_CCITT_G4, CODEC_PACKBITS, CODEC_DEFLATE, CODEC_ZSTD, CODEC_JBIG} Codec_t;
+
+extern const char *codecNames;					// names accepted by findCodec(), for help texts
+
+bool findCodec(const std::string &name, Codec_t &codec);
+unsigned short tiffCompression(Codec_t codec);	// value of TIFFTAG_COMPRESSION
+
+/*
+ * StripEncoder compresses the strips of a monochrome TIFF on their own, so they can be compressed on any thread
+ * and written with TIFFWriteRawStrip(). Pixels are bits, most significant first, 1 for black. Errors are thrown
+ * as std::string.
+ *
+ * JBIG is a single stream for the whole image, as libtiff only reads JBIG images of one strip: see JbigEncoder.
+ */
+class StripEncoder
+{
+private:
+	Codec_t codec;
+	CcittEncoder ccitt;
+	std::vector<unsigned char> buffer;
+
+	void packBits(const unsigned char *row, size_t bytes);
+
+public:
+	explicit StripEncoder(Codec_t codec = CODEC_CCITT_RLE) : codec(codec), ccitt(codec == CODEC_CCITT_G4) { }
+
+	// encoded strip, kept until the next one
+	const std::vector<unsigned char> &data() const { return codec <= CODEC_CCITT_G4 ? ccitt.data : buffer; }
+	void encode(const unsigned char *bitmap, unsigned width, unsigned rows, size_t bytesPerRow);
+
+	// CCITT strips can also be encoded row by row from the changing pixels, see CcittEncoder::encodeRow()
+	bool encodesRows() const { return codec <= CODEC_CCITT_G4; }
+	void beginStrip() { ccitt.clear(); }
+	void encodeRow(const int *changes, size_t count, unsigned width) { ccitt.encodeRow(changes, count, width); }
+	void endStrip() { ccitt.endStrip(); }
+};
+
+/*
+ * JbigEncoder compresses a monochrome image as one JBIG (ITU-T T.85) stream, fed one strip after the other.
+ * The whole stream is written as the only strip of the TIFF once the last row is in.
+ */
+class JbigEncoder
+{
+private:
+	void *state;								// struct jbg85_enc_state
+	size_t bytesPerRow;
+	std::vector<unsigned char> rows;			// the last three rows, as the encoder looks two rows up
+	unsigned rowCount;
+
+	JbigEncoder(const JbigEncoder &);			// not copyable
+	JbigEncoder &operator=(const JbigEncoder &);
+
+	static void output(unsigned char *start, size_t length, void *encoder);
+
+public:
+	std::vector<unsigned char> data;			// encoded image so far
+
+	JbigEncoder(unsigned width, unsigned height);
+	~JbigEncoder();
+	void encode(const unsigned char *bitmap, unsigned count, size_t bitmapBytesPerRow);
+};
+
+#endif // COMPRESSION_H_
@@ -7,20 +7,23 @@
 #include <math.h>
 #include <iostream>
 #include <fstream>
+#include <algorithm>
+#include <limits.h>
 
 using namespace ::std;
 
 #include "polygon.h"
 #include "apertures.h"
 #include "gerber.h"
+#include "parallel.h"
 // #include "gerber_flex.h"
 
-void yyerror(Gerber *g, const char *bisonMessage)
+void yyerror(Gerber *g, yyscan_t yyscanner, const char *bisonMessage)
 {
 	string str = bisonMessage;
-	size_t found = str.find("$undefined"); // replace the "$undefined" word in bison error string
+	size_t found = str.find("invalid token"); // replace the "invalid token" words in bison error string
 	if (found != string::npos)
-		str.replace(found, string::npos, "'" + string(yytext) + "'");
+		str.replace(found, string::npos, "'" + string(yyget_text(yyscanner)) + "'");
 	found = str.find("syntax error");
 	if (found != string::npos)
 	{
@@ -103,28 +106,145 @@ double Gerber::dotsPerUnit()
 	}
 }
 
+//
+// Precompute the coordinate scale factors used by getCoordinate().
+// Must be called whenever the format (FS) or units (MO, G70, G71) change.
+//
+void Gerber::updateCoordinateScale()
+{
+	if (coordsInts[0] >= 0) // FS parameter already given
+	{
+		for (int axis = 0; axis < 2; axis++)
+			coordDivisor[axis] = pow(10, double(coordsDecimals[axis]));
+	}
+
+	// Leave the units unresolved here, so the "without units" warning is only given if coordinates are really used without them.
+	coordDotsPerUnit = (units == UNDEFINED) ? 0 : dotsPerUnit();
+}
+
 //
 // Flash Aperture. Adds the polygon of the currently selected aperture to the polygon list, including sub aperture.
 //
 void Gerber::flashAperture(double x, double y)
 {
-	// Aperture::composite points to aperture in the link list that must be plotted in succession.
-	Aperture *arp = &*(apertureSelect);
-	while (arp)
+	if (apertureSelect->shape == 0)
+		apertureSelect->shape = makeShape(*apertureSelect);
+
+	Flash flash;
+	flash.shape = apertureSelect->shape;
+	flash.offset = Point(x * scaleFactor[0], -y * scaleFactor[1]);
+	flash.number = drawingOrder++;
+	flash.pixelMinX = flash.pixelMinY = flash.pixelMaxX = flash.pixelMaxY = 0;
+	flash.isClear = layerPolarityClear; // invert all sub polygons polarity when %PLC*% parameter specified.
+	flashes.push_back(flash);
+}
+
+//
+// Copies the polygons of an aperture into a Shape. Aperture::composite points to aperture in the link list
+// that must be plotted in succession. The shape keeps its own copy, so it is not affected when the
+// aperture is redefined or the aperture list cleared by M02.
+//
+const Shape *Gerber::makeShape(const Aperture &aperture)
+{
+	int count = 0;
+	for (const Aperture *arp = &aperture; arp; arp = arp->composite)
+		count += int(arp->polygons.size());
+
+	Polygon *shapePolygons = (Polygon *)arena.allocate(count * sizeof(Polygon), alignof(Polygon));
+	Shape *shape = arena.create<Shape>();
+	shape->polygons = shapePolygons;
+	shape->count = 0;
+	for (const Aperture *arp = &aperture; arp; arp = arp->composite)
+	{
+		for (vector<Polygon>::const_iterator it = arp->polygons.begin(); it != arp->polygons.end(); it++)
+		{
+			if (it->vdata->empty())
+				continue; // nothing to draw
+			new (&shapePolygons[shape->count++]) Polygon(*it);
+		}
+	}
+	return shape;
+}
+
+//
+// Adds a new polygon, with its own vertices, to the image.
+//
+Polygon &Gerber::newPolygon()
+{
+	polygons.push_back(Polygon(arena));
+	vertexdata.push_back(polygons.back().vdata); // Save pointer to vertex data for the newly created Polygon
+	polygons.back().number = drawingOrder++;
+	if (layerPolarityClear)
+	{
+		polygons.back().polarity = CLEAR;
+	} // polygon polarity dependent on PLC / PLD parameters
+	return polygons.back();
+}
+
+//
+// SR parameter. Closes the current step and repeat block by adding a copy of its polygons at every other
+// position of the X by Y array, then opens a new block with the given repeats and steps (in file units).
+// The copies only carry a new offset: they share the vertices and scan line data of the block's polygons.
+// The steps are converted to pixels when the block opens, as coordinate data would be then, so MO, FS, SF or
+// MI parameters inside the block, or M02 resetting them, do not move the copies. Like coordinates, they
+// ignore AS.
+//
+void Gerber::stepRepeat(int x, int y, double i, double j)
+{
+	size_t first = polygons.size();
+	size_t firstFlash = flashes.size();
+	if (repeat.X > 1 || repeat.Y > 1)
+	{
+		first = repeat.polygonsBefore;
+		firstFlash = repeat.flashesBefore;
+	}
+	if (first != polygons.size() || firstFlash != flashes.size())
 	{
-		for (list<Polygon>::iterator it = arp->polygons.begin(); it != arp->polygons.end(); it++)
+		size_t last = polygons.size();
+		size_t lastFlash = flashes.size();
+		int blockSize = drawingOrder - repeat.firstNumber; // each copy is numbered after the previous one
+		int copy = 0;
+		for (int row = 0; row < repeat.Y; row++)
 		{
-			polygons.push_back(*it); // Copy polygon from aperture
-			polygons.back().offset.x = x * scaleFactor[0];
-			polygons.back().offset.y = -y * scaleFactor[1];
-			// invert all sub polygons polarity when %PLC*% parameter specified.
-			if (layerPolarityClear)
+			for (int column = 0; column < repeat.X; column++)
 			{
-				polygons.back().polarity = CLEAR;
+				if (row == 0 && column == 0)
+					continue; // the block itself
+				copy++;
+				for (size_t p = first; p < last; p++)
+				{
+					Polygon polygon = polygons[p];
+					polygon.offset.x += column * repeat.stepX;
+					polygon.offset.y += row * repeat.stepY;
+					polygon.number += copy * blockSize;
+					polygons.push_back(polygon);
+				}
+				for (size_t f = firstFlash; f < lastFlash; f++)
+				{
+					Flash flash = flashes[f];
+					flash.offset.x += column * repeat.stepX;
+					flash.offset.y += row * repeat.stepY;
+					flash.number += copy * blockSize;
+					flashes.push_back(flash);
+				}
 			}
 		}
-		arp = arp->composite;
+		drawingOrder += copy * blockSize;
 	}
+
+	repeat.X = max(x, 1);
+	repeat.Y = max(y, 1);
+	repeat.stepX = repeat.stepY = 0;
+	if (i != 0 || j != 0)
+	{
+		if (coordDotsPerUnit == 0)
+			coordDotsPerUnit = dotsPerUnit(); // units still unknown, warns once and defaults to inches
+		repeat.stepX = i * coordDotsPerUnit * scaleFactor[0];
+		repeat.stepY = -j * coordDotsPerUnit * scaleFactor[1];
+	}
+	repeat.polygonsBefore = polygons.size();
+	repeat.flashesBefore = flashes.size();
+	repeat.firstNumber = drawingOrder;
 }
 
 /*
@@ -242,22 +362,37 @@ double Gerber::getCoordinate(char *text, int axis, bool is_I_J)
 		coordsDecimals[0] = coordsDecimals[1] = 3;
 		isOmitLeadingZeroes = true;
 		isCoordsAbsolute = true;
+		updateCoordinateScale();
 	}
 
-	double value = atoi(text);
+	bool negative = (text[0] == '-');
 	if (text[0] == '-' || text[0] == '+')
 		text++;
 
-	int excess_digits = (int)strlen(text) - (coordsDecimals[axis] + coordsInts[axis]);
+	// Decode the digits as a 64 bit integer, so formats with more than 9 digits (e.g. FS 4.6 in inches) do not overflow.
+	unsigned long long digitsValue = 0;
+	int digitCount = 0;
+	while (text[digitCount] >= '0' && text[digitCount] <= '9')
+	{
+		digitsValue = digitsValue * 10 + unsigned(text[digitCount] - '0');
+		digitCount++;
+	}
+	double value = (digitCount <= 19) ? double(digitsValue) : strtod(text, 0);
+	if (negative)
+		value = -value;
+
+	int excess_digits = digitCount - (coordsDecimals[axis] + coordsInts[axis]);
 	if (excess_digits > 0)
 		warning("found %d surplus digits in coordinate ", excess_digits);
 
 	if (isOmitLeadingZeroes)
-		value /= pow(10, double(coordsDecimals[axis]));
+		value /= coordDivisor[axis];
 	else
-		value /= pow(10, double((int)strlen(text) - coordsInts[axis])); // bug fixed: added int cast to strlen()
+		value /= pow(10, double(digitCount - coordsInts[axis])); // trailing zeroes omitted, the divisor depends on the digit count
 
-	value *= dotsPerUnit(); // convert to pixels
+	if (coordDotsPerUnit == 0)
+		coordDotsPerUnit = dotsPerUnit(); // units still unknown, warns once and defaults to inches
+	value *= coordDotsPerUnit; // convert to pixels
 	if (!is_I_J)
 		value += imageOffsetPixels[axis]; // Offset adjustment,
 
@@ -279,19 +414,15 @@ void Gerber::process_AD_block(int DCode)
 	Aperture *arp = 0;
 
 	// if aperture D code has already been defined then replace it
-	for (list<Aperture>::iterator it = ad_apertures.begin(); it != ad_apertures.end(); it++)
-	{
-		if (it->DCode == DCode)
-		{
-			arp = &(*it);
-			break;
-		}
-	}
+	unordered_map<int, list<Aperture>::iterator>::iterator defined = apertureByDCode.find(DCode);
+	if (defined != apertureByDCode.end())
+		arp = &*defined->second;
 	// Create a new aperture object for this AD code.
 	if (arp == 0)
 	{
 		ad_apertures.push_back(Aperture()); // blank aperture
 		arp = &ad_apertures.back();
+		apertureByDCode[DCode] = --ad_apertures.end();
 	}
 
 	// Aperture type references a previously defined macro aperture. We find a match
@@ -304,10 +435,11 @@ void Gerber::process_AD_block(int DCode)
 	// matching Aperture object. Using the Aperture::composite member allows plotting of all primitives when only
 	// only the first primitive in the AM block list is known.
 	// note: apertures having single character names, C, R, O or P have been predefined.
-	for (list<Aperture>::iterator amacro = macro_apertures.begin(); amacro != macro_apertures.end(); amacro++)
+	// macroByName holds the matches of each name in list order.
+	unordered_map<string, vector<list<Aperture>::iterator> >::iterator matches = macroByName.find(temporaryNameMacro);
+	for (size_t m = 0; matches != macroByName.end() && m < matches->second.size(); m++)
 	{
-		if (temporaryNameMacro != amacro->nameMacro)
-			continue; // search for a macro name match.
+		list<Aperture>::iterator amacro = matches->second[m];
 
 		// Subsequent macro name matches mean this aperture is built up of multiple aperture primitives.
 		// The <composite> member points to the subsequent primitive Aperture object as a link list.
@@ -325,15 +457,20 @@ void Gerber::process_AD_block(int DCode)
 
 		try
 		{
-			arp->render(dotsPerUnit(), growSize, variables.size());
+			arp->render(dotsPerUnit(), growSize, variables, arena);
 			// New polygons object for this aperture have been created, we can now scale the vertices, and save pointer to new vertex data.
-			for (list<Polygon>::iterator it = arp->polygons.begin(); it != arp->polygons.end(); it++)
+			for (vector<Polygon>::iterator it = arp->polygons.begin(); it != arp->polygons.end(); it++)
 			{
 				it->vdata->scale(scaleFactor[0], -scaleFactor[1]);
 				vertexdata.push_back(it->vdata);
 			}
 			if (arp->polygons.size() == 0) // if aperture is blank then don't add it to the list
+			{
+				defined = apertureByDCode.find(ad_apertures.back().DCode);
+				if (defined != apertureByDCode.end() && &*defined->second == &ad_apertures.back())
+					apertureByDCode.erase(defined);
 				ad_apertures.pop_back();   // this should never happen ???????
+			}
 		}
 		catch (string msg)
 		{
@@ -378,9 +515,15 @@ void Gerber::process_G_command(int code)
 	if (code == 75)
 		isCircular360 = true;
 	if (code == 70)
+	{
 		units = INCH; // assign dimensions to inches (synonymous to %MOIN)
+		updateCoordinateScale();
+	}
 	if (code == 71)
+	{
 		units = MILLIMETER; // assign dimensions to millimetres (synonymous to %MOMM)
+		updateCoordinateScale();
+	}
 	if (code == 90)
 		isCoordsAbsolute = true; // (synonymous to %FS)
 	if (code == 91)
@@ -395,12 +538,7 @@ void Gerber::process_G_command(int code)
 	{
 		isLampOn = false; // Always start with lamp off so tool can be positioned after a G36 command with lamp off
 		isPolygonFill = true;
-		polygons.push_back(Polygon());
-		vertexdata.push_back(polygons.back().vdata); // Save pointer to vertex data for the newly created Polygon
-		if (layerPolarityClear)
-		{
-			polygons.back().polarity = CLEAR;
-		} // polygon polarity dependent on PLC / PLD parameters
+		newPolygon();
 	}
 }
 
@@ -410,14 +548,10 @@ void Gerber::process_D_command(int code)
 	if (code >= 10)
 	{
 		// search for a Aperture list with a matching D_number, use default aperture if not found.
-		apertureSelect = ad_apertures.begin();
-		apertureSelect++;
-		for (; apertureSelect != ad_apertures.end(); apertureSelect++)
-		{
-			if (code == apertureSelect->DCode)
-				break;
-		}
-		if (apertureSelect == ad_apertures.end())
+		unordered_map<int, list<Aperture>::iterator>::iterator defined = apertureByDCode.find(code);
+		if (defined != apertureByDCode.end())
+			apertureSelect = defined->second;
+		else
 		{ // default to first in list
 			apertureSelect = ad_apertures.begin();
 			warning("Aperture D%d has not been defined", code);
@@ -538,12 +672,7 @@ void Gerber::processDataBlock()
 						if ((dX * dY) < 0)
 							sx *= -1;
 					}
-					polygons.push_back(Polygon());
-					vertexdata.push_back(polygons.back().vdata); // Save pointer to vertex data for the newly created Polygon
-					if (layerPolarityClear)
-					{
-						polygons.back().polarity = CLEAR;
-					} // polygon polarity dependent on PLC / PLD parameters
+					newPolygon();
 					polygons.back().vdata->add(oldX + sx, oldY + sy);
 					polygons.back().vdata->add(oldX - sx, oldY - sy);
 					polygons.back().vdata->add(X - sx, Y - sy);
@@ -562,15 +691,10 @@ void Gerber::processDataBlock()
 				calculateArc(arc);
 				if (!arc.isTooSmall)
 				{
-					polygons.push_back(Polygon());
-					vertexdata.push_back(polygons.back().vdata); // Save pointer to vertex data for the newly created Polygon
+					newPolygon();
 					polygons.back().vdata->addArc(arc.start, arc.end, arc.radius - (polygon_heigth) / 2, arc.centre.x, arc.centre.y, (drawingMode == CIRCLE_CLOCKWISE));
 					polygons.back().vdata->addArc(arc.end, arc.start, arc.radius + (polygon_heigth) / 2, arc.centre.x, arc.centre.y, (drawingMode != CIRCLE_CLOCKWISE));
 					polygons.back().vdata->scale(scaleFactor[0], -scaleFactor[1]);
-					if (layerPolarityClear)
-					{
-						polygons.back().polarity = CLEAR;
-					} // polygon polarity dependent on PLC / PLD parameters
 					oldX = arc.stopped.x; // set oldX,oldY to stopped point of arc
 					oldY = arc.stopped.y;
 				}
@@ -616,13 +740,10 @@ void Gerber::loadDefaults()
 	lastDrawnApertureSelect = ad_apertures.begin();
 	isWarnNoApertureSelect = false;
 	layerPolarityClear = false;
+	stepRepeat(1, 1, 0, 0); // an open step and repeat block ends here
 	scaleFactor[0] = optScaleX;
 	scaleFactor[1] = optScaleY;
 	imageOffsetPixels[0] = imageOffsetPixels[1] = 0;
-	repeat.X = 1;
-	repeat.Y = 1;
-	repeat.I = 0;
-	repeat.J = 0;
 	isLampOn = false;
 	isMirrorAaxis = false;
 	isMirrorBaxis = false;
@@ -638,27 +759,30 @@ void Gerber::loadDefaults()
 	// The macro modifiers will be of variable type, listed from $1 to $5. Note, the P aperture can have up to 5 modifiers.
 	macro_apertures.clear();
 	ad_apertures.clear();
+	macroByName.clear();
+	apertureByDCode.clear();
 	Aperture arp;
-	arp.parameter.resize(5);
+	std::vector<NodeT *> modifiers(5);
 	for (int i = 0; i < 5; i++)
 	{
-		arp.parameter[i] = new NodeT(NodeT::VAR, &i, &variables);
+		modifiers[i] = arena.create<NodeT>(NodeT::VAR, &i, &variables);
 	}
+	arp.parameter.compile(modifiers);
 	arp.nameMacro = "C";
 	arp.primitive = Aperture::STANDARD_CIRCLE;
-	macro_apertures.push_back(arp);
+	addMacroPrimitive(arp);
 
 	arp.nameMacro = "R";
 	arp.primitive = Aperture::STANDARD_RECTANGLE;
-	macro_apertures.push_back(arp);
+	addMacroPrimitive(arp);
 
 	arp.nameMacro = "O";
 	arp.primitive = Aperture::STANDARD_ORBROUND;
-	macro_apertures.push_back(arp);
+	addMacroPrimitive(arp);
 
 	arp.nameMacro = "P";
 	arp.primitive = Aperture::STANDARD_POLYGON;
-	macro_apertures.push_back(arp);
+	addMacroPrimitive(arp);
 
 	// Create an aperture definition consisting of single pixel wide circle.
 	// This will be the first aperture in the list and is to be the default aperture.
@@ -671,6 +795,15 @@ void Gerber::loadDefaults()
 	units = ut;							   // restore previous units
 }
 
+//
+// Appends a primitive to macro_apertures and indexes it under its macro name.
+//
+void Gerber::addMacroPrimitive(const Aperture &primitive)
+{
+	macro_apertures.push_back(primitive);
+	macroByName[primitive.nameMacro].push_back(--macro_apertures.end());
+}
+
 // ***********************************************************************
 // The Gerber constructor. This is the function called by the user to parse
 // the Gerber RS-274X file and create drawing information so the image can
@@ -689,8 +822,8 @@ void Gerber::loadDefaults()
 // contain useful information.
 //
 // *****************************************************************************
-Gerber::Gerber(FILE *fp_gerb, const double dotsPerInch, const double growSize, double optScaleX, double optScaleY)
-	: dotsPerInch(dotsPerInch), growSize(growSize), optScaleX(optScaleX), optScaleY(optScaleY)
+Gerber::Gerber(FILE *fp_gerb, const double dotsPerInch, const double growSize, double optScaleX, double optScaleY, unsigned threads)
+	: dotsPerInch(dotsPerInch), growSize(growSize), optScaleX(optScaleX), optScaleY(optScaleY), threads(threads)
 {
 
 	if (!fp_gerb)
@@ -698,18 +831,69 @@ Gerber::Gerber(FILE *fp_gerb, const double dotsPerInch, const double growSize, d
 		throw std::runtime_error("File pointer is null");
 	}
 
-	// Проверка размера файла
-	fseek(fp_gerb, 0, SEEK_END);
-	long fileSize = ftell(fp_gerb);
-	rewind(fp_gerb);
+	// No seek to measure the file here, so that pipes such as standard input can be read.
+	if (yylex_init(&scanner))
+	{
+		throw std::runtime_error("Cannot create scanner");
+	}
+	yyrestart(fp_gerb, scanner); // set a new input file for FLEX, flushes input buffer.
+	parse();
+}
 
-	if (fileSize <= 0)
+//
+// Parse a Gerber file mapped into memory. FLEX scans the mapped pages in place, without
+// copying them through its own input buffer.
+//
+Gerber::Gerber(MappedFile &file, const double dotsPerInch, const double growSize, double optScaleX, double optScaleY, unsigned threads)
+	: dotsPerInch(dotsPerInch), growSize(growSize), optScaleX(optScaleX), optScaleY(optScaleY), threads(threads)
+{
+	if (!file.isOpen())
+	{
+		throw std::runtime_error("File is not open");
+	}
+	if (file.size() == 0)
 	{
 		throw std::runtime_error("File is empty or invalid");
 	}
 
-	rewind(fp_gerb);
+	if (yylex_init(&scanner))
+	{
+		throw std::runtime_error("Cannot create scanner");
+	}
+	yy_scan_buffer(file.data(), file.size() + 2, scanner); // +2 for the two '\0' characters MappedFile places after the data
+	parse();
+}
+
+//
+// Parse Gerber data already held in memory by the caller, e.g. passed to the DLL.
+// The data is read only, so FLEX scans a single private copy of it.
+//
+Gerber::Gerber(const char *data, size_t size, const double dotsPerInch, const double growSize, double optScaleX, double optScaleY, unsigned threads)
+	: dotsPerInch(dotsPerInch), growSize(growSize), optScaleX(optScaleX), optScaleY(optScaleY), threads(threads)
+{
+	if (!data)
+	{
+		throw std::runtime_error("Data pointer is null");
+	}
+	if (size == 0)
+	{
+		throw std::runtime_error("Data is empty");
+	}
+
+	if (yylex_init(&scanner))
+	{
+		throw std::runtime_error("Cannot create scanner");
+	}
+	yy_scan_bytes(data, int(size), scanner);
+	parse();
+}
 
+//
+// Parse the input already handed to FLEX by the constructor, then build the polygons.
+// FLEX buffers are released when finished, so the input may be freed by the caller afterwards.
+//
+void Gerber::parse()
+{
 	try
 	{
 		imageRotate = 0;
@@ -719,48 +903,102 @@ Gerber::Gerber(FILE *fp_gerb, const double dotsPerInch, const double growSize, d
 		currentLine = 1;
 		coordsInts[0] = -1; // assign to negative value until FS parameter encounter
 		units = UNDEFINED;
+		coordDotsPerUnit = 0;
+		drawingOrder = 0;
+		repeat.X = repeat.Y = 1; // no step and repeat block open
 
 		loadDefaults();
 
-		yyrestart(fp_gerb); // set a new input file for FLEX, flushes input buffer.
-
-		yyparse(this);
+		yyparse(this, scanner);
+		stepRepeat(1, 1, 0, 0); // close a step and repeat block still open at end of file
 
-		// Modify then Initialise all vertices used by the polygons
-		for (list<VertexData *>::iterator it = vertexdata.begin(); it != vertexdata.end(); it++)
+		// Modify then Initialise all vertices used by the polygons. Each is independent of the others, the
+		// threads take chunks in turn. The scan line data is left to the Rasterizer.
+		parallelForChunks(vertexdata.size(), 64, threads, [&](size_t begin, size_t end)
 		{
+			for (size_t n = begin; n < end; n++)
+			{
+				vertexdata[n]->rotate(imageRotate); // Rotate the vertices specified by the Image Rotate parameter.
+				vertexdata[n]->initialise();
+			}
+		});
 
-			(*it)->rotate(imageRotate); // Rotate the vertices specified by the Image Rotate parameter.
-			(*it)->initialise();
-		}
-
-		// Initialise the polygons
+		// Identify each polygon and flash with a drawing order number, in order of creation.
+		// The polygons of a flashed shape are numbered in turn.
 		int k = 0;
-		for (list<Polygon>::iterator it = polygons.begin(); it != polygons.end();)
+		size_t p = 0, keptPolygons = 0;
+		size_t f = 0, kept = 0;
+		while (p < polygons.size() || f < flashes.size())
 		{
-			if (it->empty())
+			if (f == flashes.size() || (p < polygons.size() && polygons[p].number < flashes[f].number))
 			{
-
-				it = polygons.erase(it);
-				continue;
+				Polygon &polygon = polygons[p++];
+				if (polygon.empty())
+					continue;
+				polygon.number = k++;
+				polygons[keptPolygons++] = polygon;
+			}
+			else
+			{
+				Flash &flash = flashes[f++];
+				if (flash.shape->count == 0)
+					continue;
+				flash.number = k;
+				k += flash.shape->count;
+				flashes[kept++] = flash;
 			}
-
-			// Rotate entire gerber image as specified by IR parameter
-			it->offset.rotate(imageRotate);
-
-			it->initialise(); // Initialise to calculate raster x1,x2 data.
-
-			// Identify each polygon with a drawing order number.
-			it->number = k;
-			k++;
-			it++;
 		}
+		polygons.erase(polygons.begin() + keptPolygons, polygons.end());
+		flashes.resize(kept);
 
-		if (polygons.size() == 0)
+		if (polygons.size() == 0 && flashes.size() == 0)
 			warning("nothing to draw");
 
-		// Sort all polygons object so they have ascending miny values.
-		polygons.sort();
+		// Initialise the polygons and flashes
+		parallelForChunks(polygons.size(), 1024, threads, [&](size_t begin, size_t end)
+		{
+			for (size_t n = begin; n < end; n++)
+			{
+				// Rotate entire gerber image as specified by IR parameter
+				polygons[n].offset.rotate(imageRotate);
+
+				polygons[n].initialise(); // Initialise to calculate raster x1,x2 data.
+			}
+		});
+		parallelForChunks(flashes.size(), 1024, threads, [&](size_t begin, size_t end)
+		{
+			for (size_t n = begin; n < end; n++)
+			{
+				Flash &flash = flashes[n];
+				flash.offset.rotate(imageRotate);
+				flash.pixelMinX = flash.pixelMinY = INT_MAX;
+				flash.pixelMaxX = flash.pixelMaxY = INT_MIN;
+				for (int i = 0; i < flash.shape->count; i++)
+				{
+					Polygon polygon = flash.shape->polygons[i];
+					polygon.offset = flash.offset;
+					polygon.initialise();
+					flash.pixelMinX = min(flash.pixelMinX, polygon.pixelMinX);
+					flash.pixelMinY = min(flash.pixelMinY, polygon.pixelMinY);
+					flash.pixelMaxX = max(flash.pixelMaxX, polygon.pixelMaxX);
+					flash.pixelMaxY = max(flash.pixelMaxY, polygon.pixelMaxY);
+				}
+			}
+		});
+
+		// Sort all polygons object so they have ascending miny values, and move them to the store.
+		vector<size_t> order;
+		parallelSortByKey(polygons.size(), threads, [&](size_t n) { return polygons[n].pixelMinY; }, order);
+		store.reserve(polygons.size());
+		for (size_t n = 0; n < order.size(); n++)
+			store.add(polygons[order[n]]);
+		vector<Polygon>().swap(polygons);
+		parallelSortByKey(flashes.size(), threads, [&](size_t n) { return flashes[n].pixelMinY; }, order);
+		vector<Flash> sorted;
+		sorted.reserve(flashes.size());
+		for (size_t n = 0; n < order.size(); n++)
+			sorted.push_back(flashes[order[n]]);
+		flashes.swap(sorted);
 	}
 	catch (const string &msg)
 	{
@@ -777,4 +1015,7 @@ Gerber::Gerber(FILE *fp_gerb, const double dotsPerInch, const double growSize, d
 		isError = true;
 		errorMessage << "error: Unknown exception. stopped at line " << currentLine;
 	}
+
+	yylex_destroy(scanner); // release FLEX buffers, they may point into memory owned by the caller
+	scanner = 0;
 }
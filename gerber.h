@@ -10,6 +10,7 @@
 #include <complex>
 #include <vector>
 #include <list>
+#include <unordered_map>
 #include <math.h>
 #include <ctype.h>
 #include "getopt.h"
@@ -18,6 +19,7 @@
 
 #include "polygon.h"
 #include "apertures.h"
+#include "mapped_file.h"
 
 
 using namespace::std;
@@ -44,20 +46,33 @@ typedef struct T_Arc
 } Arc;
 
 
-extern char *yytext;
-extern void yyrestart( FILE *new_file );
+// The FLEX scanner is reentrant: all of its state lives in a yyscan_t owned by each Gerber object,
+// so several Gerber objects may be parsed at the same time on different threads.
+#ifndef YY_TYPEDEF_YY_SCANNER_T
+#define YY_TYPEDEF_YY_SCANNER_T
+typedef void *yyscan_t;
+#endif
+typedef struct yy_buffer_state *YY_BUFFER_STATE;
+union YYSTYPE;
+extern int yylex_init( yyscan_t *scanner );
+extern int yylex_destroy( yyscan_t scanner );
+extern void yyrestart( FILE *new_file, yyscan_t scanner );
+extern YY_BUFFER_STATE yy_scan_buffer( char *base, size_t size, yyscan_t scanner );
+extern YY_BUFFER_STATE yy_scan_bytes( const char *bytes, int len, yyscan_t scanner );
+extern char *yyget_text( yyscan_t scanner );
 
 
 class Gerber {
 
 
-	friend  int yylex(Gerber *gerb);
-	friend  int yyparse(Gerber *gerb);
+	friend  int yylex(union YYSTYPE *yylval_param, Gerber *gerb, yyscan_t yyscanner);
+	friend  int yyparse(Gerber *gerb, yyscan_t yyscanner);
 	private:
 		const double dotsPerInch; // Порядок изменен для соответствия инициализации
 		const double growSize;
 		const double optScaleX;
 		const double optScaleY;
+		const unsigned threads;		// threads preparing the polygons after parsing
 		enum APETURE_DRAWING_MODE {CIRCLE_CLOCKWISE, CIRCLE_ANTICLOCKWISE, LINEAR_10X, LINEAR_1X, LINEAR_01X, LINEAR_001X, CIRCULAR360, _INVALID_};
 		typedef enum {MILLIMETER, INCH, UNDEFINED} Units_t ;
 
@@ -101,7 +116,10 @@ class Gerber {
 		double oldY;
 		double I;
 		double J;
+		double coordDivisor[2];			// 10^decimals of each axis from the FS parameter, used to scale coordinate data
+		double coordDotsPerUnit;		// dotsPerUnit() cached for coordinate data, 0 while the units are not known
 		double dotsPerUnit();
+		void updateCoordinateScale();
 		const char * unitText() {
 			switch (units) {
 				case MILLIMETER: return "mm";
@@ -117,18 +135,30 @@ class Gerber {
 		void process_G_command(int code);
 		void processDataBlock();
 		void flashAperture(double x, double y);
+		const Shape *makeShape(const Aperture &aperture);
+		Polygon &newPolygon();
+		int drawingOrder;				// number of the next polygon or flash, in order of creation
 		void loadDefaults();
+		void parse();
+		yyscan_t scanner;				// FLEX scanner state for this object, only valid during construction
+		Arena arena;					// owns the vertex data and macro expressions, released with this object
         std::list< Aperture > macro_apertures;
         std::list< Aperture > ad_apertures;
+        std::unordered_map< int, std::list< Aperture >::iterator > apertureByDCode;	// first aperture in ad_apertures with each D code
+        std::unordered_map< string, std::vector< std::list< Aperture >::iterator > > macroByName;	// primitives of each macro in macro_apertures order
+        void addMacroPrimitive(const Aperture &primitive);
 
         struct StepRpeatBlock
         {
-        	string buffer;
         	int X;
         	int Y;
-        	double I;
-        	double J;
+        	double stepX;					// pixels between copies, scaled and mirrored as coordinates were at SR
+        	double stepY;
+        	size_t polygonsBefore;			// number of polygons before the block
+        	size_t flashesBefore;			// number of flashes before the block
+        	int firstNumber;				// drawingOrder at the start of the block
         } repeat;
+        void stepRepeat(int x, int y, double i, double j);
 
 
 	public: //---------------------------
@@ -141,14 +171,19 @@ class Gerber {
 		std::ostringstream errorMessage;			// string of occurring error
 		bool isError;
 
-		list<Polygon> polygons;		// Contains a complete polygons list to build an image of this gerber file.
-		list<VertexData *> vertexdata;	// Vertices information used by each new polygon requiring a new set of vertices.
+		vector<Polygon> polygons;	// Polygons created while parsing, moved to 'store' once initialised.
+		PolygonStore store;			// Polygons of this gerber file, sorted by first scan line. Valid while this object exists.
+		vector<Flash> flashes;		// Flashed apertures, drawn in turn with the polygons. Sorted by first scan line.
+		vector<VertexData *> vertexdata;	// Vertices information used by each new polygon requiring a new set of vertices.
 
-		Gerber(FILE * fp_gerb, double ImageDPI, double GrowSize, double optScaleX, double optScaleY);
+		// threads: number of threads preparing the polygons once the file is parsed, 0 for one per processor
+		Gerber(FILE * fp_gerb, double ImageDPI, double GrowSize, double optScaleX, double optScaleY, unsigned threads = 1);
+		Gerber(MappedFile &file, double ImageDPI, double GrowSize, double optScaleX, double optScaleY, unsigned threads = 1);
+		Gerber(const char * data, size_t size, double ImageDPI, double GrowSize, double optScaleX, double optScaleY, unsigned threads = 1);
 };
 
 
-extern void yyerror( Gerber *g, const char * msg);
+extern void yyerror( Gerber *g, yyscan_t yyscanner, const char * msg);
 
 
 
@@ -1,16 +1,61 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
+/* Bison implementation for Yacc-like parsers in C
 
-/* Identify Bison output.  */
-#define YYBISON 1
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
 
-/* Bison version.  */
-#define YYBISON_VERSION "2.4.2"
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* C LALR(1) parser skeleton written by Richard Stallman, by
+   simplifying the original so-called "semantic" parser.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+/* All symbols defined below should begin with yy or YY, to avoid
+   infringing on user name space.  This should be done even for local
+   variables, as they might otherwise be expanded by user macros.
+   There are some unavoidable exceptions within include files to
+   define necessary library symbols; they are noted "INFRINGES ON
+   USER NAME SPACE" below.  */
+
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
+
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
 
 /* Skeleton name.  */
 #define YYSKELETON_NAME "yacc.c"
 
 /* Pure parsers.  */
-#define YYPURE 0
+#define YYPURE 2
 
 /* Push parsers.  */
 #define YYPUSH 0
@@ -18,677 +63,718 @@
 /* Pull parsers.  */
 #define YYPULL 1
 
-/* Using locations.  */
-#define YYLSP_NEEDED 0
-
-/* Copy the first part of user declarations.  */
 
-/* Line 189 of yacc.c  */
-#line 4 "src/gerber_bison.yy"
 
-#include "gerber.h"
 
-/* Line 189 of yacc.c  */
-#line 79 "src/gerber_bison.cc"
+/* First part of user prologue.  */
+#line 4 "gerber_bison.yy"
 
-/* Enabling traces.  */
-#ifndef YYDEBUG
-#define YYDEBUG 0
-#endif
 
-/* Enabling verbose error messages.  */
-#ifdef YYERROR_VERBOSE
-#undef YYERROR_VERBOSE
-#define YYERROR_VERBOSE 1
-#else
-#define YYERROR_VERBOSE 1
-#endif
+#include "gerber.h"
 
-/* Enabling the token table.  */
-#ifndef YYTOKEN_TABLE
-#define YYTOKEN_TABLE 1
-#endif
 
-/* Tokens.  */
-#ifndef YYTOKENTYPE
-#define YYTOKENTYPE
-/* Put the tokens into the symbol table, so that GDB and other debuggers
-   know about them.  */
-enum yytokentype
+#line 77 "gerber_bison.cc"
+
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
+# ifndef YY_NULLPTR
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
+#  else
+#   define YY_NULLPTR ((void*)0)
+#  endif
+# endif
+
+#include "gerber_bison.h"
+/* Symbol kind.  */
+enum yysymbol_kind_t
 {
-  PARAMETER_ADD = 258,
-  PARAMETER_AM = 259,
-  PARAMETER = 260,
-  NUMBER = 261,
-  VARIABLE = 262,
-  CODE = 263,
-  SYMBOL_X = 264,
-  MACRONAME = 265,
-  UNARY = 266
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_PARAMETER_ADD = 3,              /* PARAMETER_ADD  */
+  YYSYMBOL_PARAMETER_AM = 4,               /* PARAMETER_AM  */
+  YYSYMBOL_PARAMETER = 5,                  /* PARAMETER  */
+  YYSYMBOL_NUMBER = 6,                     /* NUMBER  */
+  YYSYMBOL_VARIABLE = 7,                   /* VARIABLE  */
+  YYSYMBOL_CODE = 8,                       /* CODE  */
+  YYSYMBOL_SYMBOL_X = 9,                   /* SYMBOL_X  */
+  YYSYMBOL_MACRONAME = 10,                 /* MACRONAME  */
+  YYSYMBOL_11_ = 11,                       /* '+'  */
+  YYSYMBOL_12_ = 12,                       /* '-'  */
+  YYSYMBOL_13_X_ = 13,                     /* 'X'  */
+  YYSYMBOL_14_ = 14,                       /* '/'  */
+  YYSYMBOL_UNARY = 15,                     /* UNARY  */
+  YYSYMBOL_16_ = 16,                       /* '%'  */
+  YYSYMBOL_17_ = 17,                       /* '*'  */
+  YYSYMBOL_18_ = 18,                       /* ','  */
+  YYSYMBOL_19_S_ = 19,                     /* 'S'  */
+  YYSYMBOL_20_R_ = 20,                     /* 'R'  */
+  YYSYMBOL_21_ = 21,                       /* '('  */
+  YYSYMBOL_22_ = 22,                       /* ')'  */
+  YYSYMBOL_23_D_ = 23,                     /* 'D'  */
+  YYSYMBOL_24_G_ = 24,                     /* 'G'  */
+  YYSYMBOL_25_M_ = 25,                     /* 'M'  */
+  YYSYMBOL_YYACCEPT = 26,                  /* $accept  */
+  YYSYMBOL_gerber = 27,                    /* gerber  */
+  YYSYMBOL_data_block = 28,                /* data_block  */
+  YYSYMBOL_paramRS274_list = 29,           /* paramRS274_list  */
+  YYSYMBOL_paramRS274 = 30,                /* paramRS274  */
+  YYSYMBOL_ad_modifier_list = 31,          /* ad_modifier_list  */
+  YYSYMBOL_ad_number = 32,                 /* ad_number  */
+  YYSYMBOL_am_primitive_list = 33,         /* am_primitive_list  */
+  YYSYMBOL_am_primitve = 34,               /* am_primitve  */
+  YYSYMBOL_expr_list = 35,                 /* expr_list  */
+  YYSYMBOL_expr = 36,                      /* expr  */
+  YYSYMBOL_command_list = 37,              /* command_list  */
+  YYSYMBOL_command = 38,                   /* command  */
+  YYSYMBOL_asterisk = 39                   /* asterisk  */
 };
-#endif
-/* Tokens.  */
-#define PARAMETER_ADD 258
-#define PARAMETER_AM 259
-#define PARAMETER 260
-#define NUMBER 261
-#define VARIABLE 262
-#define CODE 263
-#define SYMBOL_X 264
-#define MACRONAME 265
-#define UNARY 266
-
-#if !defined YYSTYPE && !defined YYSTYPE_IS_DECLARED
-typedef union YYSTYPE
-{
+typedef enum yysymbol_kind_t yysymbol_kind_t;
 
-/* Line 214 of yacc.c  */
-#line 11 "src/gerber_bison.yy"
 
-  char *YS_string;
-  double YS_float;
-  int YS_int;
-  NodeT *YS_NodeT;
 
-/* Line 214 of yacc.c  */
-#line 146 "src/gerber_bison.cc"
-} YYSTYPE;
-#define YYSTYPE_IS_TRIVIAL 1
-#define yystype YYSTYPE /* obsolescent; will be withdrawn */
-#define YYSTYPE_IS_DECLARED 1
-#endif
 
-/* Copy the second part of user declarations.  */
+#ifdef short
+# undef short
+#endif
 
-/* Line 264 of yacc.c  */
-#line 158 "src/gerber_bison.cc"
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
 
-#ifdef short
-#undef short
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
 #endif
 
-#ifdef YYTYPE_UINT8
-typedef YYTYPE_UINT8 yytype_uint8;
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
+
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
 #else
-typedef unsigned char yytype_uint8;
+typedef signed char yytype_int8;
 #endif
 
-#ifdef YYTYPE_INT8
-typedef YYTYPE_INT8 yytype_int8;
-#elif (defined __STDC__ || defined __C99__FUNC__ || defined __cplusplus || defined _MSC_VER)
-typedef signed char yytype_int8;
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
 #else
-typedef short int yytype_int8;
+typedef short yytype_int16;
+#endif
+
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
+#else
+typedef short yytype_uint8;
 #endif
 
-#ifdef YYTYPE_UINT16
-typedef YYTYPE_UINT16 yytype_uint16;
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
 #else
-typedef unsigned short int yytype_uint16;
+typedef int yytype_uint16;
 #endif
 
-#ifdef YYTYPE_INT16
-typedef YYTYPE_INT16 yytype_int16;
-#else
-typedef short int yytype_int16;
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
 #endif
 
 #ifndef YYSIZE_T
-#ifdef __SIZE_TYPE__
-#define YYSIZE_T __SIZE_TYPE__
-#elif defined size_t
-#define YYSIZE_T size_t
-#elif !defined YYSIZE_T && (defined __STDC__ || defined __C99__FUNC__ || defined __cplusplus || defined _MSC_VER)
-#include <stddef.h> /* INFRINGES ON USER NAME SPACE */
-#define YYSIZE_T size_t
-#else
-#define YYSIZE_T unsigned int
-#endif
+# ifdef __SIZE_TYPE__
+#  define YYSIZE_T __SIZE_TYPE__
+# elif defined size_t
+#  define YYSIZE_T size_t
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYSIZE_T size_t
+# else
+#  define YYSIZE_T unsigned
+# endif
 #endif
 
-#define YYSIZE_MAXIMUM ((YYSIZE_T) - 1)
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_int8 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
 
 #ifndef YY_
-#if defined YYENABLE_NLS && YYENABLE_NLS
-#if ENABLE_NLS
-#include <libintl.h> /* INFRINGES ON USER NAME SPACE */
-#define YY_(msgid) dgettext("bison-runtime", msgid)
-#endif
+# if defined YYENABLE_NLS && YYENABLE_NLS
+#  if ENABLE_NLS
+#   include <libintl.h> /* INFRINGES ON USER NAME SPACE */
+#   define YY_(Msgid) dgettext ("bison-runtime", Msgid)
+#  endif
+# endif
+# ifndef YY_
+#  define YY_(Msgid) Msgid
+# endif
 #endif
-#ifndef YY_
-#define YY_(msgid) msgid
+
+
+#ifndef YY_ATTRIBUTE_PURE
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
 #endif
+
+#ifndef YY_ATTRIBUTE_UNUSED
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
+# else
+#  define YY_ATTRIBUTE_UNUSED
+# endif
 #endif
 
 /* Suppress unused-variable warnings by "using" E.  */
-#if !defined lint || defined __GNUC__
-#define YYUSE(e) ((void)(e))
+#if ! defined lint || defined __GNUC__
+# define YY_USE(E) ((void) (E))
 #else
-#define YYUSE(e) /* empty */
+# define YY_USE(E) /* empty */
+#endif
+
+/* Suppress an incorrect diagnostic about yylval being uninitialized.  */
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
+    _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
+    _Pragma ("GCC diagnostic pop")
+#else
+# define YY_INITIAL_VALUE(Value) Value
+#endif
+#ifndef YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END
+#endif
+#ifndef YY_INITIAL_VALUE
+# define YY_INITIAL_VALUE(Value) /* Nothing. */
 #endif
 
-/* Identity function, used to suppress warnings about constant conditions.  */
-#ifndef lint
-#define YYID(n) (n)
-#else
-#if (defined __STDC__ || defined __C99__FUNC__ || defined __cplusplus || defined _MSC_VER)
-static int
-YYID(int yyi)
-#else
-static int
-YYID(yyi)
-int yyi;
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
 #endif
-{
-  return yyi;
-}
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
 #endif
 
-#if !defined yyoverflow || YYERROR_VERBOSE
 
-/* The parser invokes alloca or malloc; define the necessary symbols.  */
+#define YY_ASSERT(E) ((void) (0 && (E)))
 
-#ifdef YYSTACK_USE_ALLOCA
-#if YYSTACK_USE_ALLOCA
-#ifdef __GNUC__
-#define YYSTACK_ALLOC __builtin_alloca
-#elif defined __BUILTIN_VA_ARG_INCR
-#include <alloca.h> /* INFRINGES ON USER NAME SPACE */
-#elif defined _AIX
-#define YYSTACK_ALLOC __alloca
-#elif defined _MSC_VER
-#include <malloc.h> /* INFRINGES ON USER NAME SPACE */
-#define alloca _alloca
-#else
-#define YYSTACK_ALLOC alloca
-#if !defined _ALLOCA_H && !defined _STDLIB_H && (defined __STDC__ || defined __C99__FUNC__ || defined __cplusplus || defined _MSC_VER)
-#include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
-#ifndef _STDLIB_H
-#define _STDLIB_H 1
-#endif
-#endif
-#endif
-#endif
-#endif
+#if 1
 
-#ifdef YYSTACK_ALLOC
-/* Pacify GCC's `empty if-body' warning.  */
-#define YYSTACK_FREE(Ptr) \
-  do                      \
-  { /* empty */           \
-    ;                     \
-  } while (YYID(0))
-#ifndef YYSTACK_ALLOC_MAXIMUM
-/* The OS might guarantee only one guard page at the bottom of the stack,
-   and a page size can be as small as 4096 bytes.  So we cannot safely
-   invoke alloca (N) if N exceeds 4096.  Use a slightly smaller number
-   to allow for a few compiler-allocated temporary stack slots.  */
-#define YYSTACK_ALLOC_MAXIMUM 4032 /* reasonable circa 2006 */
-#endif
-#else
-#define YYSTACK_ALLOC YYMALLOC
-#define YYSTACK_FREE YYFREE
-#ifndef YYSTACK_ALLOC_MAXIMUM
-#define YYSTACK_ALLOC_MAXIMUM YYSIZE_MAXIMUM
-#endif
-#if (defined __cplusplus && !defined _STDLIB_H && !((defined YYMALLOC || defined malloc) && (defined YYFREE || defined free)))
-#include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
-#ifndef _STDLIB_H
-#define _STDLIB_H 1
-#endif
-#endif
-#ifndef YYMALLOC
-#define YYMALLOC malloc
-#if !defined malloc && !defined _STDLIB_H && (defined __STDC__ || defined __C99__FUNC__ || defined __cplusplus || defined _MSC_VER)
-void *malloc(YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
-#endif
-#endif
-#ifndef YYFREE
-#define YYFREE free
-#if !defined free && !defined _STDLIB_H && (defined __STDC__ || defined __C99__FUNC__ || defined __cplusplus || defined _MSC_VER)
-void free(void *); /* INFRINGES ON USER NAME SPACE */
-#endif
-#endif
-#endif
-#endif /* ! defined yyoverflow || YYERROR_VERBOSE */
+/* The parser invokes alloca or malloc; define the necessary symbols.  */
 
-#if (!defined yyoverflow && (!defined __cplusplus || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
+# ifdef YYSTACK_USE_ALLOCA
+#  if YYSTACK_USE_ALLOCA
+#   ifdef __GNUC__
+#    define YYSTACK_ALLOC __builtin_alloca
+#   elif defined __BUILTIN_VA_ARG_INCR
+#    include <alloca.h> /* INFRINGES ON USER NAME SPACE */
+#   elif defined _AIX
+#    define YYSTACK_ALLOC __alloca
+#   elif defined _MSC_VER
+#    include <malloc.h> /* INFRINGES ON USER NAME SPACE */
+#    define alloca _alloca
+#   else
+#    define YYSTACK_ALLOC alloca
+#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS
+#     include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+      /* Use EXIT_SUCCESS as a witness for stdlib.h.  */
+#     ifndef EXIT_SUCCESS
+#      define EXIT_SUCCESS 0
+#     endif
+#    endif
+#   endif
+#  endif
+# endif
+
+# ifdef YYSTACK_ALLOC
+   /* Pacify GCC's 'empty if-body' warning.  */
+#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (0)
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+    /* The OS might guarantee only one guard page at the bottom of the stack,
+       and a page size can be as small as 4096 bytes.  So we cannot safely
+       invoke alloca (N) if N exceeds 4096.  Use a slightly smaller number
+       to allow for a few compiler-allocated temporary stack slots.  */
+#   define YYSTACK_ALLOC_MAXIMUM 4032 /* reasonable circa 2006 */
+#  endif
+# else
+#  define YYSTACK_ALLOC YYMALLOC
+#  define YYSTACK_FREE YYFREE
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+#   define YYSTACK_ALLOC_MAXIMUM YYSIZE_MAXIMUM
+#  endif
+#  if (defined __cplusplus && ! defined EXIT_SUCCESS \
+       && ! ((defined YYMALLOC || defined malloc) \
+             && (defined YYFREE || defined free)))
+#   include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+#   ifndef EXIT_SUCCESS
+#    define EXIT_SUCCESS 0
+#   endif
+#  endif
+#  ifndef YYMALLOC
+#   define YYMALLOC malloc
+#   if ! defined malloc && ! defined EXIT_SUCCESS
+void *malloc (YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+#  ifndef YYFREE
+#   define YYFREE free
+#   if ! defined free && ! defined EXIT_SUCCESS
+void free (void *); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+# endif
+#endif /* 1 */
+
+#if (! defined yyoverflow \
+     && (! defined __cplusplus \
+         || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
 
 /* A type that is properly aligned for any stack member.  */
 union yyalloc
 {
-  yytype_int16 yyss_alloc;
+  yy_state_t yyss_alloc;
   YYSTYPE yyvs_alloc;
 };
 
 /* The size of the maximum gap between one aligned stack and the next.  */
-#define YYSTACK_GAP_MAXIMUM (sizeof(union yyalloc) - 1)
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
 
 /* The size of an array large to enough to hold all stacks, each with
    N elements.  */
-#define YYSTACK_BYTES(N) \
-  ((N) * (sizeof(yytype_int16) + sizeof(YYSTYPE)) + YYSTACK_GAP_MAXIMUM)
+# define YYSTACK_BYTES(N) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE)) \
+      + YYSTACK_GAP_MAXIMUM)
 
-/* Copy COUNT objects from FROM to TO.  The source and destination do
-   not overlap.  */
-#ifndef YYCOPY
-#if defined __GNUC__ && 1 < __GNUC__
-#define YYCOPY(To, From, Count) \
-  __builtin_memcpy(To, From, (Count) * sizeof(*(From)))
-#else
-#define YYCOPY(To, From, Count)         \
-  do                                    \
-  {                                     \
-    YYSIZE_T yyi;                       \
-    for (yyi = 0; yyi < (Count); yyi++) \
-      (To)[yyi] = (From)[yyi];          \
-  } while (YYID(0))
-#endif
-#endif
+# define YYCOPY_NEEDED 1
 
 /* Relocate STACK from its old location to the new one.  The
    local variables YYSIZE and YYSTACKSIZE give the old and new number of
    elements in the stack, and YYPTR gives the new location of the
    stack.  Advance YYPTR to a properly aligned location for the next
    stack.  */
-#define YYSTACK_RELOCATE(Stack_alloc, Stack)                         \
-  do                                                                 \
-  {                                                                  \
-    YYSIZE_T yynewbytes;                                             \
-    YYCOPY(&yyptr->Stack_alloc, Stack, yysize);                      \
-    Stack = &yyptr->Stack_alloc;                                     \
-    yynewbytes = yystacksize * sizeof(*Stack) + YYSTACK_GAP_MAXIMUM; \
-    yyptr += yynewbytes / sizeof(*yyptr);                            \
-  } while (YYID(0))
+# define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
+    do                                                                  \
+      {                                                                 \
+        YYPTRDIFF_T yynewbytes;                                         \
+        YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
+        Stack = &yyptr->Stack_alloc;                                    \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
+      }                                                                 \
+    while (0)
 
 #endif
 
+#if defined YYCOPY_NEEDED && YYCOPY_NEEDED
+/* Copy COUNT objects from SRC to DST.  The source and destination do
+   not overlap.  */
+# ifndef YYCOPY
+#  if defined __GNUC__ && 1 < __GNUC__
+#   define YYCOPY(Dst, Src, Count) \
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
+#  else
+#   define YYCOPY(Dst, Src, Count)              \
+      do                                        \
+        {                                       \
+          YYPTRDIFF_T yyi;                      \
+          for (yyi = 0; yyi < (Count); yyi++)   \
+            (Dst)[yyi] = (Src)[yyi];            \
+        }                                       \
+      while (0)
+#  endif
+# endif
+#endif /* !YYCOPY_NEEDED */
+
 /* YYFINAL -- State number of the termination state.  */
-#define YYFINAL 19
+#define YYFINAL  20
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST 76
+#define YYLAST   79
 
 /* YYNTOKENS -- Number of terminals.  */
-#define YYNTOKENS 24
+#define YYNTOKENS  26
 /* YYNNTS -- Number of nonterminals.  */
-#define YYNNTS 14
+#define YYNNTS  14
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES 41
-/* YYNRULES -- Number of states.  */
-#define YYNSTATES 70
+#define YYNRULES  42
+/* YYNSTATES -- Number of states.  */
+#define YYNSTATES  72
 
-/* YYTRANSLATE(YYLEX) -- Bison symbol number corresponding to YYLEX.  */
-#define YYUNDEFTOK 2
-#define YYMAXUTOK 266
+/* YYMAXUTOK -- Last valid token kind.  */
+#define YYMAXUTOK   266
 
-#define YYTRANSLATE(YYX) \
-  ((unsigned int)(YYX) <= YYMAXUTOK ? yytranslate[YYX] : YYUNDEFTOK)
 
-/* YYTRANSLATE[YYLEX] -- Bison symbol number corresponding to YYLEX.  */
-static const yytype_uint8 yytranslate[] =
-    {
-        0, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 16, 2, 2,
-        19, 20, 17, 11, 18, 12, 2, 14, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2, 21, 2,
-        2, 22, 2, 2, 2, 2, 2, 23, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2, 13, 2,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 1, 2, 3, 4,
-        5, 6, 7, 8, 9, 10, 15};
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
+
+/* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
+{
+       0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,    16,     2,     2,
+      21,    22,    17,    11,    18,    12,     2,    14,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,    23,     2,
+       2,    24,     2,     2,     2,     2,     2,    25,     2,     2,
+       2,     2,    20,    19,     2,     2,     2,     2,    13,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     1,     2,     3,     4,
+       5,     6,     7,     8,     9,    10,    15
+};
 
 #if YYDEBUG
-/* YYPRHS[YYN] -- Index of the first RHS symbol of rule number YYN in
-   YYRHS.  */
-static const yytype_uint8 yyprhs[] =
-    {
-        0, 0, 3, 5, 8, 12, 19, 22, 24, 26,
-        29, 33, 35, 40, 43, 45, 49, 52, 55, 58,
-        60, 63, 67, 71, 73, 77, 79, 81, 85, 89,
-        93, 97, 100, 103, 107, 109, 112, 115, 118, 121,
-        123, 125};
-
-/* YYRHS -- A `-1'-separated list of the rules' RHS.  */
-static const yytype_int8 yyrhs[] =
-    {
-        25, 0, -1, 26, -1, 25, 26, -1, 16, 27,
-        16, -1, 16, 4, 10, 31, 37, 16, -1, 35,
-        17, -1, 17, -1, 16, -1, 28, 37, -1, 27,
-        28, 37, -1, 5, -1, 3, 10, 18, 29, -1,
-        3, 10, -1, 30, -1, 29, 13, 30, -1, 29,
-        13, -1, 12, 6, -1, 11, 6, -1, 6, -1,
-        37, 32, -1, 31, 37, 32, -1, 6, 18, 33,
-        -1, 34, -1, 33, 18, 34, -1, 7, -1, 6,
-        -1, 34, 11, 34, -1, 34, 12, 34, -1, 34,
-        13, 34, -1, 34, 14, 34, -1, 12, 34, -1,
-        11, 34, -1, 19, 34, 20, -1, 36, -1, 35,
-        36, -1, 21, 6, -1, 22, 6, -1, 23, 6,
-        -1, 8, -1, 17, -1, 37, 17, -1};
-
-/* YYRLINE[YYN] -- source line where rule number YYN was defined.  */
-static const yytype_uint8 yyrline[] =
-    {
-        0, 43, 43, 44, 46, 47, 48, 49, 50, 55,
-        56, 58, 59, 60, 62, 63, 64, 66, 67, 68,
-        70, 71, 73, 83, 84, 86, 87, 88, 89, 90,
-        91, 92, 93, 94, 96, 97, 99, 100, 101, 102,
-        104, 105};
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+static const yytype_int8 yyrline[] =
+{
+       0,    49,    49,    50,    52,    53,    54,    55,    56,    61,
+      62,    64,    65,    66,    67,    69,    70,    71,    73,    74,
+      75,    77,    78,    80,    91,    92,    94,    95,    96,    97,
+      98,    99,   100,   101,   102,   104,   105,   107,   108,   109,
+     110,   112,   113
+};
 #endif
 
-#if YYDEBUG || YYERROR_VERBOSE || YYTOKEN_TABLE
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if 1
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
 /* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
    First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
 static const char *const yytname[] =
-    {
-        "$end", "error", "$undefined", "PARAMETER_ADD", "PARAMETER_AM",
-        "PARAMETER", "NUMBER", "VARIABLE", "CODE", "SYMBOL_X", "MACRONAME",
-        "'+'", "'-'", "'X'", "'/'", "UNARY", "'%'", "'*'", "','", "'('", "')'",
-        "'D'", "'G'", "'M'", "$accept", "gerber", "data_block",
-        "paramRS274_list", "paramRS274", "ad_modifier_list", "ad_number",
-        "am_primitive_list", "am_primitve", "expr_list", "expr", "command_list",
-        "command", "asterisk", 0};
-#endif
+{
+  "\"end of file\"", "error", "\"invalid token\"", "PARAMETER_ADD",
+  "PARAMETER_AM", "PARAMETER", "NUMBER", "VARIABLE", "CODE", "SYMBOL_X",
+  "MACRONAME", "'+'", "'-'", "'X'", "'/'", "UNARY", "'%'", "'*'", "','",
+  "'S'", "'R'", "'('", "')'", "'D'", "'G'", "'M'", "$accept", "gerber",
+  "data_block", "paramRS274_list", "paramRS274", "ad_modifier_list",
+  "ad_number", "am_primitive_list", "am_primitve", "expr_list", "expr",
+  "command_list", "command", "asterisk", YY_NULLPTR
+};
 
-#ifdef YYPRINT
-/* YYTOKNUM[YYLEX-NUM] -- Internal token number corresponding to
-   token YYLEX-NUM.  */
-static const yytype_uint16 yytoknum[] =
-    {
-        0, 256, 257, 258, 259, 260, 261, 262, 263, 264,
-        265, 43, 45, 88, 47, 266, 37, 42, 44, 40,
-        41, 68, 71, 77};
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
+{
+  return yytname[yysymbol];
+}
 #endif
 
-/* YYR1[YYN] -- Symbol number of symbol that rule YYN derives.  */
-static const yytype_uint8 yyr1[] =
-    {
-        0, 24, 25, 25, 26, 26, 26, 26, 26, 27,
-        27, 28, 28, 28, 29, 29, 29, 30, 30, 30,
-        31, 31, 32, 33, 33, 34, 34, 34, 34, 34,
-        34, 34, 34, 34, 35, 35, 36, 36, 36, 36,
-        37, 37};
-
-/* YYR2[YYN] -- Number of symbols composing right hand side of rule YYN.  */
-static const yytype_uint8 yyr2[] =
-    {
-        0, 2, 1, 2, 3, 6, 2, 1, 1, 2,
-        3, 1, 4, 2, 1, 3, 2, 2, 2, 1,
-        2, 3, 3, 1, 3, 1, 1, 3, 3, 3,
-        3, 2, 2, 3, 1, 2, 2, 2, 2, 1,
-        1, 2};
-
-/* YYDEFACT[STATE-NAME] -- Default rule to reduce with in state
-   STATE-NUM when YYTABLE doesn't specify something else to do.  Zero
-   means the default is an error.  */
-static const yytype_uint8 yydefact[] =
-    {
-        0, 39, 8, 7, 0, 0, 0, 0, 2, 0,
-        34, 0, 0, 11, 0, 0, 36, 37, 38, 1,
-        3, 6, 35, 13, 0, 4, 0, 40, 9, 0,
-        0, 0, 10, 41, 19, 0, 0, 12, 14, 0,
-        0, 20, 18, 17, 16, 5, 21, 0, 15, 26,
-        25, 0, 0, 0, 22, 23, 32, 31, 0, 0,
-        0, 0, 0, 0, 33, 24, 27, 28, 29, 30};
+#define YYPACT_NINF (-13)
 
-/* YYDEFGOTO[NTERM-NUM].  */
-static const yytype_int8 yydefgoto[] =
-    {
-        -1, 7, 8, 14, 15, 37, 38, 30, 41, 54,
-        55, 9, 10, 28};
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
+
+#define YYTABLE_NINF (-1)
+
+#define yytable_value_is_error(Yyn) \
+  0
 
 /* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
    STATE-NUM.  */
-#define YYPACT_NINF -15
 static const yytype_int8 yypact[] =
-    {
-        -3, -15, 40, -15, -4, 28, 31, 0, -15, 7,
-        -15, 37, 48, -15, 30, -14, -15, -15, -15, -15,
-        -15, -15, -15, 43, -14, -15, -14, -15, 21, -2,
-        -14, 19, 21, -15, -15, 54, 62, 56, -15, -5,
-        52, -15, -15, -15, -2, -15, -15, 20, -15, -15,
-        -15, 20, 20, 20, 55, 53, -15, -15, 42, 20,
-        20, 20, 20, 20, -15, 53, -7, -7, -15, -15};
+{
+      -5,   -13,     2,   -13,     3,     4,     8,     0,   -13,     5,
+     -13,    -6,    22,   -13,    25,    28,    17,   -13,   -13,   -13,
+     -13,   -13,   -13,   -13,    40,    17,   -13,   -13,    17,   -13,
+      47,    37,    17,     9,    47,   -13,   -13,    64,    65,    59,
+     -13,    21,    56,   -13,   -13,   -13,    37,   -13,   -13,    29,
+     -13,   -13,   -13,    29,    29,    29,    57,    55,   -13,   -13,
+      43,    29,    29,    29,    29,    29,   -13,    55,   -12,   -12,
+     -13,   -13
+};
+
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
+static const yytype_int8 yydefact[] =
+{
+       0,    40,     8,     7,     0,     0,     0,     0,     2,     0,
+      35,     0,     0,    11,     0,     0,     0,    37,    38,    39,
+       1,     3,     6,    36,    13,     0,    14,     4,     0,    41,
+       9,     0,     0,     0,    10,    42,    20,     0,     0,    12,
+      15,     0,     0,    21,    19,    18,    17,     5,    22,     0,
+      16,    27,    26,     0,     0,     0,    23,    24,    33,    32,
+       0,     0,     0,     0,     0,     0,    34,    25,    28,    29,
+      30,    31
+};
 
 /* YYPGOTO[NTERM-NUM].  */
 static const yytype_int8 yypgoto[] =
-    {
-        -15, -15, 64, -15, 58, -15, 32, -15, 35, -15,
-        -11, -15, 66, 33};
-
-/* YYTABLE[YYPACT[STATE-NUM]].  What to do in state STATE-NUM.  If
-   positive, shift that token.  If negative, reduce the rule which
-   number is the opposite.  If zero, do what YYDEFACT says.
-   If YYTABLE_NINF, syntax error.  */
-#define YYTABLE_NINF -1
-static const yytype_uint8 yytable[] =
-    {
-        19, 40, 16, 27, 34, 1, 62, 63, 1, 35,
-        36, 45, 33, 2, 3, 1, 2, 3, 4, 5,
-        6, 4, 5, 6, 21, 40, 49, 50, 4, 5,
-        6, 51, 52, 11, 17, 13, 33, 18, 33, 53,
-        56, 57, 58, 11, 12, 13, 25, 23, 65, 66,
-        67, 68, 69, 60, 61, 62, 63, 31, 24, 32,
-        42, 29, 64, 39, 60, 61, 62, 63, 43, 44,
-        47, 20, 26, 59, 46, 22, 48};
-
-static const yytype_uint8 yycheck[] =
-    {
-        0, 6, 6, 17, 6, 8, 13, 14, 8, 11,
-        12, 16, 17, 16, 17, 8, 16, 17, 21, 22,
-        23, 21, 22, 23, 17, 6, 6, 7, 21, 22,
-        23, 11, 12, 3, 6, 5, 17, 6, 17, 19,
-        51, 52, 53, 3, 4, 5, 16, 10, 59, 60,
-        61, 62, 63, 11, 12, 13, 14, 24, 10, 26,
-        6, 18, 20, 30, 11, 12, 13, 14, 6, 13,
-        18, 7, 14, 18, 39, 9, 44};
-
-/* YYSTOS[STATE-NUM] -- The (internal number of the) accessing
-   symbol of state STATE-NUM.  */
-static const yytype_uint8 yystos[] =
-    {
-        0, 8, 16, 17, 21, 22, 23, 25, 26, 35,
-        36, 3, 4, 5, 27, 28, 6, 6, 6, 0,
-        26, 17, 36, 10, 10, 16, 28, 17, 37, 18,
-        31, 37, 37, 17, 6, 11, 12, 29, 30, 37,
-        6, 32, 6, 6, 13, 16, 32, 18, 30, 6,
-        7, 11, 12, 19, 33, 34, 34, 34, 34, 18,
-        11, 12, 13, 14, 20, 34, 34, 34, 34, 34};
-
-#define yyerrok (yyerrstatus = 0)
-#define yyclearin (yychar = YYEMPTY)
-#define YYEMPTY (-2)
-#define YYEOF 0
-
-#define YYACCEPT goto yyacceptlab
-#define YYABORT goto yyabortlab
-#define YYERROR goto yyerrorlab
-
-/* Like YYERROR except do call yyerror.  This remains here temporarily
-   to ease the transition to the new meaning of YYERROR, for GCC.
-   Once GCC version 2 has supplanted version 1, this can go.  However,
-   YYFAIL appears to be in use.  Nevertheless, it is formally deprecated
-   in Bison 2.4.2's NEWS entry, where a plan to phase it out is
-   discussed.  */
-
-#define YYFAIL goto yyerrlab
-#if defined YYFAIL
-/* This is here to suppress warnings from the GCC cpp's
-   -Wunused-macros.  Normally we don't worry about that warning, but
-   some users do, and we want to make it easy for users to remove
-   YYFAIL uses, which will produce warnings from Bison 2.5.  */
-#endif
+{
+     -13,   -13,    66,   -13,    61,   -13,    31,   -13,    38,   -13,
+      -2,   -13,    69,    14
+};
 
-#define YYRECOVERING() (!!yyerrstatus)
-
-#define YYBACKUP(Token, Value)                         \
-  do                                                   \
-    if (yychar == YYEMPTY && yylen == 1)               \
-    {                                                  \
-      yychar = (Token);                                \
-      yylval = (Value);                                \
-      yytoken = YYTRANSLATE(yychar);                   \
-      YYPOPSTACK(1);                                   \
-      goto yybackup;                                   \
-    }                                                  \
-    else                                               \
-    {                                                  \
-      yyerror(g, YY_("syntax error: cannot back up")); \
-      YYERROR;                                         \
-    }                                                  \
-  while (YYID(0))
-
-#define YYTERROR 1
-#define YYERRCODE 256
-
-/* YYLLOC_DEFAULT -- Set CURRENT to span from RHS[1] to RHS[N].
-   If N is 0, then set CURRENT to the empty location which ends
-   the previous symbol: RHS[0] (always defined).  */
-
-#define YYRHSLOC(Rhs, K) ((Rhs)[K])
-#ifndef YYLLOC_DEFAULT
-#define YYLLOC_DEFAULT(Current, Rhs, N)                       \
-  do                                                          \
-    if (YYID(N))                                              \
-    {                                                         \
-      (Current).first_line = YYRHSLOC(Rhs, 1).first_line;     \
-      (Current).first_column = YYRHSLOC(Rhs, 1).first_column; \
-      (Current).last_line = YYRHSLOC(Rhs, N).last_line;       \
-      (Current).last_column = YYRHSLOC(Rhs, N).last_column;   \
-    }                                                         \
-    else                                                      \
-    {                                                         \
-      (Current).first_line = (Current).last_line =            \
-          YYRHSLOC(Rhs, 0).last_line;                         \
-      (Current).first_column = (Current).last_column =        \
-          YYRHSLOC(Rhs, 0).last_column;                       \
-    }                                                         \
-  while (YYID(0))
-#endif
+/* YYDEFGOTO[NTERM-NUM].  */
+static const yytype_int8 yydefgoto[] =
+{
+       0,     7,     8,    15,    16,    39,    40,    32,    43,    56,
+      57,     9,    10,    30
+};
 
-/* YY_LOCATION_PRINT -- Print the location on the stream.
-   This macro was not mandated originally: define only if we know
-   we won't break user code: when these are the locations we know.  */
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
+static const yytype_int8 yytable[] =
+{
+      20,    64,    65,     1,    24,    11,    12,    13,     1,    17,
+      18,     2,     3,     1,    19,    42,     2,     3,     4,     5,
+       6,    14,    22,     4,     5,     6,    35,    42,     4,     5,
+       6,    11,    25,    13,    29,    51,    52,    47,    35,    33,
+      53,    54,    34,    36,    27,    26,    41,    14,    37,    38,
+      55,    58,    59,    60,    62,    63,    64,    65,    31,    67,
+      68,    69,    70,    71,    35,    66,    62,    63,    64,    65,
+      44,    45,    46,    21,    49,    61,    28,    50,    23,    48
+};
 
-#ifndef YY_LOCATION_PRINT
-#if defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
-#define YY_LOCATION_PRINT(File, Loc)            \
-  fprintf(File, "%d.%d-%d.%d",                  \
-          (Loc).first_line, (Loc).first_column, \
-          (Loc).last_line, (Loc).last_column)
-#else
-#define YY_LOCATION_PRINT(File, Loc) ((void)0)
-#endif
-#endif
+static const yytype_int8 yycheck[] =
+{
+       0,    13,    14,     8,    10,     3,     4,     5,     8,     6,
+       6,    16,    17,     8,     6,     6,    16,    17,    23,    24,
+      25,    19,    17,    23,    24,    25,    17,     6,    23,    24,
+      25,     3,    10,     5,    17,     6,     7,    16,    17,    25,
+      11,    12,    28,     6,    16,    20,    32,    19,    11,    12,
+      21,    53,    54,    55,    11,    12,    13,    14,    18,    61,
+      62,    63,    64,    65,    17,    22,    11,    12,    13,    14,
+       6,     6,    13,     7,    18,    18,    15,    46,     9,    41
+};
 
-/* YYLEX -- calling `yylex' with the right arguments.  */
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_int8 yystos[] =
+{
+       0,     8,    16,    17,    23,    24,    25,    27,    28,    37,
+      38,     3,     4,     5,    19,    29,    30,     6,     6,     6,
+       0,    28,    17,    38,    10,    10,    20,    16,    30,    17,
+      39,    18,    33,    39,    39,    17,     6,    11,    12,    31,
+      32,    39,     6,    34,     6,     6,    13,    16,    34,    18,
+      32,     6,     7,    11,    12,    21,    35,    36,    36,    36,
+      36,    18,    11,    12,    13,    14,    22,    36,    36,    36,
+      36,    36
+};
+
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr1[] =
+{
+       0,    26,    27,    27,    28,    28,    28,    28,    28,    29,
+      29,    30,    30,    30,    30,    31,    31,    31,    32,    32,
+      32,    33,    33,    34,    35,    35,    36,    36,    36,    36,
+      36,    36,    36,    36,    36,    37,    37,    38,    38,    38,
+      38,    39,    39
+};
+
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
+{
+       0,     2,     1,     2,     3,     6,     2,     1,     1,     2,
+       3,     1,     4,     2,     2,     1,     3,     2,     2,     2,
+       1,     2,     3,     3,     1,     3,     1,     1,     3,     3,
+       3,     3,     2,     2,     3,     1,     2,     2,     2,     2,
+       1,     1,     2
+};
+
+
+enum { YYENOMEM = -2 };
+
+#define yyerrok         (yyerrstatus = 0)
+#define yyclearin       (yychar = YYEMPTY)
+
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
+
+
+#define YYRECOVERING()  (!!yyerrstatus)
+
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (g, yyscanner, YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
 
-#ifdef YYLEX_PARAM
-#define YYLEX yylex(YYLEX_PARAM)
-#else
-#define YYLEX yylex(g)
-#endif
 
 /* Enable debugging if requested.  */
 #if YYDEBUG
 
-#ifndef YYFPRINTF
-#include <stdio.h> /* INFRINGES ON USER NAME SPACE */
-#define YYFPRINTF fprintf
-#endif
+# ifndef YYFPRINTF
+#  include <stdio.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYFPRINTF fprintf
+# endif
+
+# define YYDPRINTF(Args)                        \
+do {                                            \
+  if (yydebug)                                  \
+    YYFPRINTF Args;                             \
+} while (0)
+
+
+
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
+do {                                                                      \
+  if (yydebug)                                                            \
+    {                                                                     \
+      YYFPRINTF (stderr, "%s ", Title);                                   \
+      yy_symbol_print (stderr,                                            \
+                  Kind, Value, g, yyscanner); \
+      YYFPRINTF (stderr, "\n");                                           \
+    }                                                                     \
+} while (0)
+
+
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
 
-#define YYDPRINTF(Args) \
-  do                    \
-  {                     \
-    if (yydebug)        \
-      YYFPRINTF Args;   \
-  } while (YYID(0))
-
-#define YY_SYMBOL_PRINT(Title, Type, Value, Location) \
-  do                                                  \
-  {                                                   \
-    if (yydebug)                                      \
-    {                                                 \
-      YYFPRINTF(stderr, "%s ", Title);                \
-      yy_symbol_print(stderr,                         \
-                      Type, Value, g);                \
-      YYFPRINTF(stderr, "\n");                        \
-    }                                                 \
-  } while (YYID(0))
-
-/*--------------------------------.
-| Print this symbol on YYOUTPUT.  |
-`--------------------------------*/
-
-/*ARGSUSED*/
-#if (defined __STDC__ || defined __C99__FUNC__ || defined __cplusplus || defined _MSC_VER)
-static void
-yy_symbol_value_print(FILE *yyoutput, int yytype, YYSTYPE const *const yyvaluep, Gerber *g)
-#else
 static void
-    yy_symbol_value_print(yyoutput, yytype, yyvaluep, g)
-        FILE *yyoutput;
-int yytype;
-YYSTYPE const *const yyvaluep;
-Gerber *g;
-#endif
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, Gerber *g, yyscan_t yyscanner)
 {
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
+  YY_USE (g);
+  YY_USE (yyscanner);
   if (!yyvaluep)
     return;
-  YYUSE(g);
-#ifdef YYPRINT
-  if (yytype < YYNTOKENS)
-    YYPRINT(yyoutput, yytoknum[yytype], *yyvaluep);
-#else
-  YYUSE(yyoutput);
-#endif
-  switch (yytype)
-  {
-  default:
-    break;
-  }
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
-/*--------------------------------.
-| Print this symbol on YYOUTPUT.  |
-`--------------------------------*/
 
-#if (defined __STDC__ || defined __C99__FUNC__ || defined __cplusplus || defined _MSC_VER)
-static void
-yy_symbol_print(FILE *yyoutput, int yytype, YYSTYPE const *const yyvaluep, Gerber *g)
-#else
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
+
 static void
-    yy_symbol_print(yyoutput, yytype, yyvaluep, g)
-        FILE *yyoutput;
-int yytype;
-YYSTYPE const *const yyvaluep;
-Gerber *g;
-#endif
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, Gerber *g, yyscan_t yyscanner)
 {
-  if (yytype < YYNTOKENS)
-    YYFPRINTF(yyoutput, "token %s (", yytname[yytype]);
-  else
-    YYFPRINTF(yyoutput, "nterm %s (", yytname[yytype]);
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
 
-  yy_symbol_value_print(yyoutput, yytype, yyvaluep, g);
-  YYFPRINTF(yyoutput, ")");
+  yy_symbol_value_print (yyo, yykind, yyvaluep, g, yyscanner);
+  YYFPRINTF (yyo, ")");
 }
 
 /*------------------------------------------------------------------.
@@ -696,82 +782,69 @@ Gerber *g;
 | TOP (included).                                                   |
 `------------------------------------------------------------------*/
 
-#if (defined __STDC__ || defined __C99__FUNC__ || defined __cplusplus || defined _MSC_VER)
 static void
-yy_stack_print(yytype_int16 *yybottom, yytype_int16 *yytop)
-#else
-static void
-    yy_stack_print(yybottom, yytop)
-        yytype_int16 *yybottom;
-yytype_int16 *yytop;
-#endif
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
 {
-  YYFPRINTF(stderr, "Stack now");
+  YYFPRINTF (stderr, "Stack now");
   for (; yybottom <= yytop; yybottom++)
-  {
-    int yybot = *yybottom;
-    YYFPRINTF(stderr, " %d", yybot);
-  }
-  YYFPRINTF(stderr, "\n");
+    {
+      int yybot = *yybottom;
+      YYFPRINTF (stderr, " %d", yybot);
+    }
+  YYFPRINTF (stderr, "\n");
 }
 
-#define YY_STACK_PRINT(Bottom, Top)    \
-  do                                   \
-  {                                    \
-    if (yydebug)                       \
-      yy_stack_print((Bottom), (Top)); \
-  } while (YYID(0))
+# define YY_STACK_PRINT(Bottom, Top)                            \
+do {                                                            \
+  if (yydebug)                                                  \
+    yy_stack_print ((Bottom), (Top));                           \
+} while (0)
+
 
 /*------------------------------------------------.
 | Report that the YYRULE is going to be reduced.  |
 `------------------------------------------------*/
 
-#if (defined __STDC__ || defined __C99__FUNC__ || defined __cplusplus || defined _MSC_VER)
-static void
-yy_reduce_print(YYSTYPE *yyvsp, int yyrule, Gerber *g)
-#else
 static void
-    yy_reduce_print(yyvsp, yyrule, g)
-        YYSTYPE *yyvsp;
-int yyrule;
-Gerber *g;
-#endif
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
+                 int yyrule, Gerber *g, yyscan_t yyscanner)
 {
+  int yylno = yyrline[yyrule];
   int yynrhs = yyr2[yyrule];
   int yyi;
-  unsigned long int yylno = yyrline[yyrule];
-  YYFPRINTF(stderr, "Reducing stack by rule %d (line %lu):\n",
-            yyrule - 1, yylno);
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
+             yyrule - 1, yylno);
   /* The symbols being reduced.  */
   for (yyi = 0; yyi < yynrhs; yyi++)
-  {
-    YYFPRINTF(stderr, "   $%d = ", yyi + 1);
-    yy_symbol_print(stderr, yyrhs[yyprhs[yyrule] + yyi],
-                    &(yyvsp[(yyi + 1) - (yynrhs)]), g);
-    YYFPRINTF(stderr, "\n");
-  }
+    {
+      YYFPRINTF (stderr, "   $%d = ", yyi + 1);
+      yy_symbol_print (stderr,
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)], g, yyscanner);
+      YYFPRINTF (stderr, "\n");
+    }
 }
 
-#define YY_REDUCE_PRINT(Rule)          \
-  do                                   \
-  {                                    \
-    if (yydebug)                       \
-      yy_reduce_print(yyvsp, Rule, g); \
-  } while (YYID(0))
+# define YY_REDUCE_PRINT(Rule)          \
+do {                                    \
+  if (yydebug)                          \
+    yy_reduce_print (yyssp, yyvsp, Rule, g, yyscanner); \
+} while (0)
 
 /* Nonzero means print parse trace.  It is left uninitialized so that
    multiple parsers can coexist.  */
 int yydebug;
 #else /* !YYDEBUG */
-#define YYDPRINTF(Args)
-#define YY_SYMBOL_PRINT(Title, Type, Value, Location)
-#define YY_STACK_PRINT(Bottom, Top)
-#define YY_REDUCE_PRINT(Rule)
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
+# define YY_STACK_PRINT(Bottom, Top)
+# define YY_REDUCE_PRINT(Rule)
 #endif /* !YYDEBUG */
 
+
 /* YYINITDEPTH -- initial size of the parser's stacks.  */
 #ifndef YYINITDEPTH
-#define YYINITDEPTH 200
+# define YYINITDEPTH 200
 #endif
 
 /* YYMAXDEPTH -- maximum size the stacks can grow to (effective only
@@ -782,48 +855,84 @@ int yydebug;
    evaluated with infinite-precision integer arithmetic.  */
 
 #ifndef YYMAXDEPTH
-#define YYMAXDEPTH 10000
+# define YYMAXDEPTH 10000
 #endif
 
-#if YYERROR_VERBOSE
+
+/* Context of a parse error.  */
+typedef struct
+{
+  yy_state_t *yyssp;
+  yysymbol_kind_t yytoken;
+} yypcontext_t;
+
+/* Put in YYARG at most YYARGN of the expected tokens given the
+   current YYCTX, and return the number of tokens stored in YYARG.  If
+   YYARG is null, return the number of expected tokens (guaranteed to
+   be less than YYNTOKENS).  Return YYENOMEM on memory exhaustion.
+   Return 0 if there are more than YYARGN expected tokens, yet fill
+   YYARG up to YYARGN. */
+static int
+yypcontext_expected_tokens (const yypcontext_t *yyctx,
+                            yysymbol_kind_t yyarg[], int yyargn)
+{
+  /* Actual size of YYARG. */
+  int yycount = 0;
+  int yyn = yypact[+*yyctx->yyssp];
+  if (!yypact_value_is_default (yyn))
+    {
+      /* Start YYX at -YYN if negative to avoid negative indexes in
+         YYCHECK.  In other words, skip the first -YYN actions for
+         this state because they are default actions.  */
+      int yyxbegin = yyn < 0 ? -yyn : 0;
+      /* Stay within bounds of both yycheck and yytname.  */
+      int yychecklim = YYLAST - yyn + 1;
+      int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
+      int yyx;
+      for (yyx = yyxbegin; yyx < yyxend; ++yyx)
+        if (yycheck[yyx + yyn] == yyx && yyx != YYSYMBOL_YYerror
+            && !yytable_value_is_error (yytable[yyx + yyn]))
+          {
+            if (!yyarg)
+              ++yycount;
+            else if (yycount == yyargn)
+              return 0;
+            else
+              yyarg[yycount++] = YY_CAST (yysymbol_kind_t, yyx);
+          }
+    }
+  if (yyarg && yycount == 0 && 0 < yyargn)
+    yyarg[0] = YYSYMBOL_YYEMPTY;
+  return yycount;
+}
+
+
+
 
 #ifndef yystrlen
-#if defined __GLIBC__ && defined _STRING_H
-#define yystrlen strlen
-#else
+# if defined __GLIBC__ && defined _STRING_H
+#  define yystrlen(S) (YY_CAST (YYPTRDIFF_T, strlen (S)))
+# else
 /* Return the length of YYSTR.  */
-#if (defined __STDC__ || defined __C99__FUNC__ || defined __cplusplus || defined _MSC_VER)
-static YYSIZE_T
-yystrlen(const char *yystr)
-#else
-static YYSIZE_T
-    yystrlen(yystr)
-        const char *yystr;
-#endif
+static YYPTRDIFF_T
+yystrlen (const char *yystr)
 {
-  YYSIZE_T yylen;
+  YYPTRDIFF_T yylen;
   for (yylen = 0; yystr[yylen]; yylen++)
     continue;
   return yylen;
 }
-#endif
+# endif
 #endif
 
 #ifndef yystpcpy
-#if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
-#define yystpcpy stpcpy
-#else
+# if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
+#  define yystpcpy stpcpy
+# else
 /* Copy YYSRC to YYDEST, returning the address of the terminating '\0' in
    YYDEST.  */
-#if (defined __STDC__ || defined __C99__FUNC__ || defined __cplusplus || defined _MSC_VER)
-static char *
-yystpcpy(char *yydest, const char *yysrc)
-#else
 static char *
-yystpcpy(yydest, yysrc)
-char *yydest;
-const char *yysrc;
-#endif
+yystpcpy (char *yydest, const char *yysrc)
 {
   char *yyd = yydest;
   const char *yys = yysrc;
@@ -833,7 +942,7 @@ const char *yysrc;
 
   return yyd - 1;
 }
-#endif
+# endif
 #endif
 
 #ifndef yytnamerr
@@ -844,408 +953,407 @@ const char *yysrc;
    backslash-backslash).  YYSTR is taken from yytname.  If YYRES is
    null, do not copy; instead, return the length of what the result
    would have been.  */
-static YYSIZE_T
-yytnamerr(char *yyres, const char *yystr)
+static YYPTRDIFF_T
+yytnamerr (char *yyres, const char *yystr)
 {
   if (*yystr == '"')
-  {
-    YYSIZE_T yyn = 0;
-    char const *yyp = yystr;
+    {
+      YYPTRDIFF_T yyn = 0;
+      char const *yyp = yystr;
+      for (;;)
+        switch (*++yyp)
+          {
+          case '\'':
+          case ',':
+            goto do_not_strip_quotes;
+
+          case '\\':
+            if (*++yyp != '\\')
+              goto do_not_strip_quotes;
+            else
+              goto append;
+
+          append:
+          default:
+            if (yyres)
+              yyres[yyn] = *yyp;
+            yyn++;
+            break;
+
+          case '"':
+            if (yyres)
+              yyres[yyn] = '\0';
+            return yyn;
+          }
+    do_not_strip_quotes: ;
+    }
 
-    for (;;)
-      switch (*++yyp)
-      {
-      case '\'':
-      case ',':
-        goto do_not_strip_quotes;
-
-      case '\\':
-        if (*++yyp != '\\')
-          goto do_not_strip_quotes;
-        /* Fall through.  */
-      default:
-        if (yyres)
-          yyres[yyn] = *yyp;
-        yyn++;
-        break;
-
-      case '"':
-        if (yyres)
-          yyres[yyn] = '\0';
-        return yyn;
-      }
-  do_not_strip_quotes:;
-  }
+  if (yyres)
+    return yystpcpy (yyres, yystr) - yyres;
+  else
+    return yystrlen (yystr);
+}
+#endif
 
-  if (!yyres)
-    return yystrlen(yystr);
 
-  return yystpcpy(yyres, yystr) - yyres;
+static int
+yy_syntax_error_arguments (const yypcontext_t *yyctx,
+                           yysymbol_kind_t yyarg[], int yyargn)
+{
+  /* Actual size of YYARG. */
+  int yycount = 0;
+  /* There are many possibilities here to consider:
+     - If this state is a consistent state with a default action, then
+       the only way this function was invoked is if the default action
+       is an error action.  In that case, don't check for expected
+       tokens because there are none.
+     - The only way there can be no lookahead present (in yychar) is if
+       this state is a consistent state with a default action.  Thus,
+       detecting the absence of a lookahead is sufficient to determine
+       that there is no unexpected or expected token to report.  In that
+       case, just report a simple "syntax error".
+     - Don't assume there isn't a lookahead just because this state is a
+       consistent state with a default action.  There might have been a
+       previous inconsistent state, consistent state with a non-default
+       action, or user semantic action that manipulated yychar.
+     - Of course, the expected token list depends on states to have
+       correct lookahead information, and it depends on the parser not
+       to perform extra reductions after fetching a lookahead from the
+       scanner and before detecting a syntax error.  Thus, state merging
+       (from LALR or IELR) and default reductions corrupt the expected
+       token list.  However, the list is correct for canonical LR with
+       one exception: it will still contain any token that will not be
+       accepted due to an error action in a later state.
+  */
+  if (yyctx->yytoken != YYSYMBOL_YYEMPTY)
+    {
+      int yyn;
+      if (yyarg)
+        yyarg[yycount] = yyctx->yytoken;
+      ++yycount;
+      yyn = yypcontext_expected_tokens (yyctx,
+                                        yyarg ? yyarg + 1 : yyarg, yyargn - 1);
+      if (yyn == YYENOMEM)
+        return YYENOMEM;
+      else
+        yycount += yyn;
+    }
+  return yycount;
 }
-#endif
 
-/* Copy into YYRESULT an error message about the unexpected token
-   YYCHAR while in state YYSTATE.  Return the number of bytes copied,
-   including the terminating null byte.  If YYRESULT is null, do not
-   copy anything; just return the number of bytes that would be
-   copied.  As a special case, return 0 if an ordinary "syntax error"
-   message will do.  Return YYSIZE_MAXIMUM if overflow occurs during
-   size calculation.  */
-static YYSIZE_T
-yysyntax_error(char *yyresult, int yystate, int yychar)
+/* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
+   about the unexpected token YYTOKEN for the state stack whose top is
+   YYSSP.
+
+   Return 0 if *YYMSG was successfully written.  Return -1 if *YYMSG is
+   not large enough to hold the message.  In that case, also set
+   *YYMSG_ALLOC to the required number of bytes.  Return YYENOMEM if the
+   required number of bytes is too large to store.  */
+static int
+yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
+                const yypcontext_t *yyctx)
 {
-  int yyn = yypact[yystate];
+  enum { YYARGS_MAX = 5 };
+  /* Internationalized format string. */
+  const char *yyformat = YY_NULLPTR;
+  /* Arguments of yyformat: reported tokens (one for the "unexpected",
+     one per "expected"). */
+  yysymbol_kind_t yyarg[YYARGS_MAX];
+  /* Cumulated lengths of YYARG.  */
+  YYPTRDIFF_T yysize = 0;
+
+  /* Actual size of YYARG. */
+  int yycount = yy_syntax_error_arguments (yyctx, yyarg, YYARGS_MAX);
+  if (yycount == YYENOMEM)
+    return YYENOMEM;
+
+  switch (yycount)
+    {
+#define YYCASE_(N, S)                       \
+      case N:                               \
+        yyformat = S;                       \
+        break
+    default: /* Avoid compiler warnings. */
+      YYCASE_(0, YY_("syntax error"));
+      YYCASE_(1, YY_("syntax error, unexpected %s"));
+      YYCASE_(2, YY_("syntax error, unexpected %s, expecting %s"));
+      YYCASE_(3, YY_("syntax error, unexpected %s, expecting %s or %s"));
+      YYCASE_(4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
+      YYCASE_(5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
+#undef YYCASE_
+    }
 
-  if (!(YYPACT_NINF < yyn && yyn <= YYLAST))
-    return 0;
-  else
+  /* Compute error message size.  Don't count the "%s"s, but reserve
+     room for the terminator.  */
+  yysize = yystrlen (yyformat) - 2 * yycount + 1;
   {
-    int yytype = YYTRANSLATE(yychar);
-    YYSIZE_T yysize0 = yytnamerr(0, yytname[yytype]);
-    YYSIZE_T yysize = yysize0;
-    YYSIZE_T yysize1;
-    int yysize_overflow = 0;
-    enum
-    {
-      YYERROR_VERBOSE_ARGS_MAXIMUM = 5
-    };
-    char const *yyarg[YYERROR_VERBOSE_ARGS_MAXIMUM];
-    int yyx;
-
-#if 0
-      /* This is so xgettext sees the translatable formats that are
-	 constructed on the fly.  */
-      YY_("syntax error, unexpected %s");
-      YY_("syntax error, unexpected %s, expecting %s");
-      YY_("syntax error, unexpected %s, expecting %s or %s");
-      YY_("syntax error, unexpected %s, expecting %s or %s or %s");
-      YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s");
-#endif
-    char *yyfmt;
-    char const *yyf;
-    static char const yyunexpected[] = "syntax error, unexpected %s";
-    static char const yyexpecting[] = ", expecting %s";
-    static char const yyor[] = " or %s";
-    char yyformat[sizeof yyunexpected + sizeof yyexpecting - 1 + ((YYERROR_VERBOSE_ARGS_MAXIMUM - 2) * (sizeof yyor - 1))];
-    char const *yyprefix = yyexpecting;
-
-    /* Start YYX at -YYN if negative to avoid negative indexes in
- YYCHECK.  */
-    int yyxbegin = yyn < 0 ? -yyn : 0;
-
-    /* Stay within bounds of both yycheck and yytname.  */
-    int yychecklim = YYLAST - yyn + 1;
-    int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
-    int yycount = 1;
-
-    yyarg[0] = yytname[yytype];
-    yyfmt = yystpcpy(yyformat, yyunexpected);
-
-    for (yyx = yyxbegin; yyx < yyxend; ++yyx)
-      if (yycheck[yyx + yyn] == yyx && yyx != YYTERROR)
+    int yyi;
+    for (yyi = 0; yyi < yycount; ++yyi)
       {
-        if (yycount == YYERROR_VERBOSE_ARGS_MAXIMUM)
-        {
-          yycount = 1;
-          yysize = yysize0;
-          yyformat[sizeof yyunexpected - 1] = '\0';
-          break;
-        }
-        yyarg[yycount++] = yytname[yyx];
-        yysize1 = yysize + yytnamerr(0, yytname[yyx]);
-        yysize_overflow |= (yysize1 < yysize);
-        yysize = yysize1;
-        yyfmt = yystpcpy(yyfmt, yyprefix);
-        yyprefix = yyor;
+        YYPTRDIFF_T yysize1
+          = yysize + yytnamerr (YY_NULLPTR, yytname[yyarg[yyi]]);
+        if (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM)
+          yysize = yysize1;
+        else
+          return YYENOMEM;
       }
+  }
 
-    yyf = YY_(yyformat);
-    yysize1 = yysize + yystrlen(yyf);
-    yysize_overflow |= (yysize1 < yysize);
-    yysize = yysize1;
-
-    if (yysize_overflow)
-      return YYSIZE_MAXIMUM;
-
-    if (yyresult)
+  if (*yymsg_alloc < yysize)
     {
-      /* Avoid sprintf, as that infringes on the user's name space.
-         Don't have undefined behavior even if the translation
-         produced a string with the wrong number of "%s"s.  */
-      char *yyp = yyresult;
-      int yyi = 0;
-      while ((*yyp = *yyf) != '\0')
-      {
-        if (*yyp == '%' && yyf[1] == 's' && yyi < yycount)
+      *yymsg_alloc = 2 * yysize;
+      if (! (yysize <= *yymsg_alloc
+             && *yymsg_alloc <= YYSTACK_ALLOC_MAXIMUM))
+        *yymsg_alloc = YYSTACK_ALLOC_MAXIMUM;
+      return -1;
+    }
+
+  /* Avoid sprintf, as that infringes on the user's name space.
+     Don't have undefined behavior even if the translation
+     produced a string with the wrong number of "%s"s.  */
+  {
+    char *yyp = *yymsg;
+    int yyi = 0;
+    while ((*yyp = *yyformat) != '\0')
+      if (*yyp == '%' && yyformat[1] == 's' && yyi < yycount)
         {
-          yyp += yytnamerr(yyp, yyarg[yyi++]);
-          yyf += 2;
+          yyp += yytnamerr (yyp, yytname[yyarg[yyi++]]);
+          yyformat += 2;
         }
-        else
+      else
         {
-          yyp++;
-          yyf++;
+          ++yyp;
+          ++yyformat;
         }
-      }
-    }
-    return yysize;
   }
+  return 0;
 }
-#endif /* YYERROR_VERBOSE */
+
 
 /*-----------------------------------------------.
 | Release the memory associated to this symbol.  |
 `-----------------------------------------------*/
 
-/*ARGSUSED*/
-#if (defined __STDC__ || defined __C99__FUNC__ || defined __cplusplus || defined _MSC_VER)
 static void
-yydestruct(const char *yymsg, int yytype, YYSTYPE *yyvaluep, Gerber *g)
-#else
-static void
-    yydestruct(yymsg, yytype, yyvaluep, g)
-        const char *yymsg;
-int yytype;
-YYSTYPE *yyvaluep;
-Gerber *g;
-#endif
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, Gerber *g, yyscan_t yyscanner)
 {
-  YYUSE(yyvaluep);
-  YYUSE(g);
-
+  YY_USE (yyvaluep);
+  YY_USE (g);
+  YY_USE (yyscanner);
   if (!yymsg)
     yymsg = "Deleting";
-  YY_SYMBOL_PRINT(yymsg, yytype, yyvaluep, yylocationp);
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
 
-  switch (yytype)
-  {
-
-  default:
-    break;
-  }
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
-/* Prevent warnings from -Wmissing-prototypes.  */
-#ifdef YYPARSE_PARAM
-#if defined __STDC__ || defined __cplusplus
-int yyparse(void *YYPARSE_PARAM);
-#else
-int yyparse();
-#endif
-#else /* ! YYPARSE_PARAM */
-#if defined __STDC__ || defined __cplusplus
-int yyparse(Gerber *g);
-#else
-int yyparse();
-#endif
-#endif /* ! YYPARSE_PARAM */
 
-/* The lookahead symbol.  */
-int yychar;
 
-/* The semantic value of the lookahead symbol.  */
-YYSTYPE yylval;
 
-/* Number of syntax errors so far.  */
-int yynerrs;
 
-/*-------------------------.
-| yyparse or yypush_parse.  |
-`-------------------------*/
 
-#ifdef YYPARSE_PARAM
-#if (defined __STDC__ || defined __C99__FUNC__ || defined __cplusplus || defined _MSC_VER)
-int yyparse(void *YYPARSE_PARAM)
-#else
+/*----------.
+| yyparse.  |
+`----------*/
+
 int
-    yyparse(YYPARSE_PARAM) void *YYPARSE_PARAM;
-#endif
-#else /* ! YYPARSE_PARAM */
-#if (defined __STDC__ || defined __C99__FUNC__ || defined __cplusplus || defined _MSC_VER)
-int yyparse(Gerber *g)
-#else
-int yyparse(g)
-Gerber *g;
-#endif
-#endif
+yyparse (Gerber *g, yyscan_t yyscanner)
 {
+/* Lookahead token kind.  */
+int yychar;
 
-  int yystate;
-  /* Number of tokens to shift before error messages enabled.  */
-  int yyerrstatus;
 
-  /* The stacks and their tools:
-     `yyss': related to states.
-     `yyvs': related to semantic values.
+/* The semantic value of the lookahead symbol.  */
+/* Default value used for initialization, for pacifying older GCCs
+   or non-GCC compilers.  */
+YY_INITIAL_VALUE (static YYSTYPE yyval_default;)
+YYSTYPE yylval YY_INITIAL_VALUE (= yyval_default);
+
+    /* Number of syntax errors so far.  */
+    int yynerrs = 0;
 
-     Refer to the stacks thru separate pointers, to allow yyoverflow
-     to reallocate them elsewhere.  */
+    yy_state_fast_t yystate = 0;
+    /* Number of tokens to shift before error messages enabled.  */
+    int yyerrstatus = 0;
 
-  /* The state stack.  */
-  yytype_int16 yyssa[YYINITDEPTH];
-  yytype_int16 *yyss;
-  yytype_int16 *yyssp;
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
+       to reallocate them elsewhere.  */
 
-  /* The semantic value stack.  */
-  YYSTYPE yyvsa[YYINITDEPTH];
-  YYSTYPE *yyvs;
-  YYSTYPE *yyvsp;
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
 
-  YYSIZE_T yystacksize;
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
+
+    /* The semantic value stack: array, bottom, top.  */
+    YYSTYPE yyvsa[YYINITDEPTH];
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
 
   int yyn;
+  /* The return value of yyparse.  */
   int yyresult;
-  /* Lookahead token as an internal (translated) token number.  */
-  int yytoken;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
   /* The variables used to return semantic value and location from the
      action routines.  */
   YYSTYPE yyval;
 
-#if YYERROR_VERBOSE
   /* Buffer for error messages, and its allocated size.  */
   char yymsgbuf[128];
   char *yymsg = yymsgbuf;
-  YYSIZE_T yymsg_alloc = sizeof yymsgbuf;
-#endif
+  YYPTRDIFF_T yymsg_alloc = sizeof yymsgbuf;
 
-#define YYPOPSTACK(N) (yyvsp -= (N), yyssp -= (N))
+#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
 
   /* The number of symbols on the RHS of the reduced rule.
      Keep to zero when no symbol should be popped.  */
   int yylen = 0;
 
-  yytoken = 0;
-  yyss = yyssa;
-  yyvs = yyvsa;
-  yystacksize = YYINITDEPTH;
-
-  YYDPRINTF((stderr, "Starting parse\n"));
+  YYDPRINTF ((stderr, "Starting parse\n"));
 
-  yystate = 0;
-  yyerrstatus = 0;
-  yynerrs = 0;
   yychar = YYEMPTY; /* Cause a token to be read.  */
 
-  /* Initialize stack pointers.
-     Waste one element of value and location stack
-     so that they stay on the same level as the state stack.
-     The wasted elements are never initialized.  */
-  yyssp = yyss;
-  yyvsp = yyvs;
-
   goto yysetstate;
 
-  /*------------------------------------------------------------.
-  | yynewstate -- Push a new state, which is found in yystate.  |
-  `------------------------------------------------------------*/
+
+/*------------------------------------------------------------.
+| yynewstate -- push a new state, which is found in yystate.  |
+`------------------------------------------------------------*/
 yynewstate:
   /* In all cases, when you get here, the value and location stacks
      have just been pushed.  So pushing a state here evens the stacks.  */
   yyssp++;
 
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
 yysetstate:
-  *yyssp = yystate;
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
 
   if (yyss + yystacksize - 1 <= yyssp)
-  {
-    /* Get the current used size of the three stacks, in elements.  */
-    YYSIZE_T yysize = yyssp - yyss + 1;
-
-#ifdef yyoverflow
-    {
-      /* Give user a chance to reallocate the stack.  Use copies of
-         these so that the &'s don't force the real ones into
-         memory.  */
-      YYSTYPE *yyvs1 = yyvs;
-      yytype_int16 *yyss1 = yyss;
-
-      /* Each stack pointer address is followed by the size of the
-         data in use in that stack, in bytes.  This used to be a
-         conditional around just the two extra args, but that might
-         be undefined if yyoverflow is a macro.  */
-      yyoverflow(YY_("memory exhausted"),
-                 &yyss1, yysize * sizeof(*yyssp),
-                 &yyvs1, yysize * sizeof(*yyvsp),
-                 &yystacksize);
-
-      yyss = yyss1;
-      yyvs = yyvs1;
-    }
-#else /* no yyoverflow */
-#ifndef YYSTACK_RELOCATE
-    goto yyexhaustedlab;
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
 #else
-    /* Extend the stack our own way.  */
-    if (YYMAXDEPTH <= yystacksize)
-      goto yyexhaustedlab;
-    yystacksize *= 2;
-    if (YYMAXDEPTH < yystacksize)
-      yystacksize = YYMAXDEPTH;
-
     {
-      yytype_int16 *yyss1 = yyss;
-      union yyalloc *yyptr =
-          (union yyalloc *)YYSTACK_ALLOC(YYSTACK_BYTES(yystacksize));
-      if (!yyptr)
-        goto yyexhaustedlab;
-      YYSTACK_RELOCATE(yyss_alloc, yyss);
-      YYSTACK_RELOCATE(yyvs_alloc, yyvs);
-#undef YYSTACK_RELOCATE
-      if (yyss1 != yyssa)
-        YYSTACK_FREE(yyss1);
-    }
-#endif
-#endif /* no yyoverflow */
+      /* Get the current used size of the three stacks, in elements.  */
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
 
-    yyssp = yyss + yysize - 1;
-    yyvsp = yyvs + yysize - 1;
+# if defined yyoverflow
+      {
+        /* Give user a chance to reallocate the stack.  Use copies of
+           these so that the &'s don't force the real ones into
+           memory.  */
+        yy_state_t *yyss1 = yyss;
+        YYSTYPE *yyvs1 = yyvs;
+
+        /* Each stack pointer address is followed by the size of the
+           data in use in that stack, in bytes.  This used to be a
+           conditional around just the two extra args, but that might
+           be undefined if yyoverflow is a macro.  */
+        yyoverflow (YY_("memory exhausted"),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yystacksize);
+        yyss = yyss1;
+        yyvs = yyvs1;
+      }
+# else /* defined YYSTACK_RELOCATE */
+      /* Extend the stack our own way.  */
+      if (YYMAXDEPTH <= yystacksize)
+        YYNOMEM;
+      yystacksize *= 2;
+      if (YYMAXDEPTH < yystacksize)
+        yystacksize = YYMAXDEPTH;
 
-    YYDPRINTF((stderr, "Stack size increased to %lu\n",
-               (unsigned long int)yystacksize));
+      {
+        yy_state_t *yyss1 = yyss;
+        union yyalloc *yyptr =
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
+        if (! yyptr)
+          YYNOMEM;
+        YYSTACK_RELOCATE (yyss_alloc, yyss);
+        YYSTACK_RELOCATE (yyvs_alloc, yyvs);
+#  undef YYSTACK_RELOCATE
+        if (yyss1 != yyssa)
+          YYSTACK_FREE (yyss1);
+      }
+# endif
 
-    if (yyss + yystacksize - 1 <= yyssp)
-      YYABORT;
-  }
+      yyssp = yyss + yysize - 1;
+      yyvsp = yyvs + yysize - 1;
+
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
+
+      if (yyss + yystacksize - 1 <= yyssp)
+        YYABORT;
+    }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
 
-  YYDPRINTF((stderr, "Entering state %d\n", yystate));
 
   if (yystate == YYFINAL)
     YYACCEPT;
 
   goto yybackup;
 
+
 /*-----------.
 | yybackup.  |
 `-----------*/
 yybackup:
-
   /* Do appropriate processing given the current state.  Read a
      lookahead token if we need one and don't already have one.  */
 
   /* First try to decide what to do without reference to lookahead token.  */
   yyn = yypact[yystate];
-  if (yyn == YYPACT_NINF)
+  if (yypact_value_is_default (yyn))
     goto yydefault;
 
   /* Not known => get a lookahead token if don't already have one.  */
 
-  /* YYCHAR is either YYEMPTY or YYEOF or a valid lookahead symbol.  */
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
   if (yychar == YYEMPTY)
-  {
-    YYDPRINTF((stderr, "Reading a token: "));
-    yychar = YYLEX;
-  }
+    {
+      YYDPRINTF ((stderr, "Reading a token\n"));
+      yychar = yylex (&yylval, g, yyscanner);
+    }
 
   if (yychar <= YYEOF)
-  {
-    yychar = yytoken = YYEOF;
-    YYDPRINTF((stderr, "Now at end of input.\n"));
-  }
+    {
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
+      YYDPRINTF ((stderr, "Now at end of input.\n"));
+    }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      goto yyerrlab1;
+    }
   else
-  {
-    yytoken = YYTRANSLATE(yychar);
-    YY_SYMBOL_PRINT("Next token is", yytoken, &yylval, &yylloc);
-  }
+    {
+      yytoken = YYTRANSLATE (yychar);
+      YY_SYMBOL_PRINT ("Next token is", yytoken, &yylval, &yylloc);
+    }
 
   /* If the proper action on seeing token YYTOKEN is to reduce or to
      detect an error, take that action.  */
@@ -1254,12 +1362,12 @@ yybackup:
     goto yydefault;
   yyn = yytable[yyn];
   if (yyn <= 0)
-  {
-    if (yyn == 0 || yyn == YYTABLE_NINF)
-      goto yyerrlab;
-    yyn = -yyn;
-    goto yyreduce;
-  }
+    {
+      if (yytable_value_is_error (yyn))
+        goto yyerrlab;
+      yyn = -yyn;
+      goto yyreduce;
+    }
 
   /* Count tokens shifted since error; after three, turn off error
      status.  */
@@ -1267,16 +1375,17 @@ yybackup:
     yyerrstatus--;
 
   /* Shift the lookahead token.  */
-  YY_SYMBOL_PRINT("Shifting", yytoken, &yylval, &yylloc);
-
-  /* Discard the shifted token.  */
-  yychar = YYEMPTY;
-
+  YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
   yystate = yyn;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
   *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
   goto yynewstate;
 
+
 /*-----------------------------------------------------------.
 | yydefault -- do the default action for the current state.  |
 `-----------------------------------------------------------*/
@@ -1286,439 +1395,405 @@ yydefault:
     goto yyerrlab;
   goto yyreduce;
 
+
 /*-----------------------------.
-| yyreduce -- Do a reduction.  |
+| yyreduce -- do a reduction.  |
 `-----------------------------*/
 yyreduce:
   /* yyn is the number of a rule to reduce with.  */
   yylen = yyr2[yyn];
 
   /* If YYLEN is nonzero, implement the default value of the action:
-     `$$ = $1'.
+     '$$ = $1'.
 
      Otherwise, the following line sets YYVAL to garbage.
      This behavior is undocumented and Bison
      users should not rely upon it.  Assigning to YYVAL
      unconditionally makes the parser a bit smaller, and it avoids a
      GCC warning that YYVAL may be used uninitialized.  */
-  yyval = yyvsp[1 - yylen];
-
-  YY_REDUCE_PRINT(yyn);
-  switch (yyn)
-  {
-  case 6:
+  yyval = yyvsp[1-yylen];
 
-/* Line 1464 of yacc.c  */
-#line 48 "src/gerber_bison.yy"
-  {
-    g->processDataBlock();
-  }
-  break;
-
-  case 12:
-
-/* Line 1464 of yacc.c  */
-#line 59 "src/gerber_bison.yy"
-  {
-    g->process_AD_block((yyvsp[(1) - (4)].YS_int));
-  }
-  break;
-
-  case 13:
-
-/* Line 1464 of yacc.c  */
-#line 60 "src/gerber_bison.yy"
-  {
-    g->process_AD_block((yyvsp[(1) - (2)].YS_int));
-  }
-  break;
-
-  case 14:
-
-/* Line 1464 of yacc.c  */
-#line 62 "src/gerber_bison.yy"
-  {
-    g->variables.push_back((yyvsp[(1) - (1)].YS_float));
-  }
-  break;
-
-  case 15:
-
-/* Line 1464 of yacc.c  */
-#line 63 "src/gerber_bison.yy"
-  {
-    g->variables.push_back((yyvsp[(3) - (3)].YS_float));
-  }
-  break;
-
-  case 16:
-
-/* Line 1464 of yacc.c  */
-#line 64 "src/gerber_bison.yy"
-  {
-    g->warning("modified expected after X");
-  }
-  break;
-
-  case 17:
-
-/* Line 1464 of yacc.c  */
-#line 66 "src/gerber_bison.yy"
-  {
-    (yyval.YS_float) = -(yyvsp[(2) - (2)].YS_float);
-  }
-  break;
-
-  case 18:
-
-/* Line 1464 of yacc.c  */
-#line 67 "src/gerber_bison.yy"
-  {
-    (yyval.YS_float) = (yyvsp[(2) - (2)].YS_float);
-  }
-  break;
-
-  case 22:
-
-/* Line 1464 of yacc.c  */
-#line 74 "src/gerber_bison.yy"
-  {
-    g->macro_apertures.push_back(Aperture());
-    g->macro_apertures.back().primitive = Aperture::PRIMITIVE(int((yyvsp[(1) - (3)].YS_float)));
-    g->macro_apertures.back().parameter = g->temporaryParameters;
-    g->macro_apertures.back().nameMacro = g->temporaryNameMacro;
-    g->macro_apertures.back().linenum_at_definition = g->currentLine;
-    g->temporaryParameters.clear();
-  }
-  break;
-
-  case 23:
-
-/* Line 1464 of yacc.c  */
-#line 83 "src/gerber_bison.yy"
-  {
-    g->temporaryParameters.push_back((yyvsp[(1) - (1)].YS_NodeT));
-  }
-  break;
 
-  case 24:
-
-/* Line 1464 of yacc.c  */
-#line 84 "src/gerber_bison.yy"
-  {
-    g->temporaryParameters.push_back((yyvsp[(3) - (3)].YS_NodeT));
-  }
-  break;
+  YY_REDUCE_PRINT (yyn);
+  switch (yyn)
+    {
+  case 6: /* data_block: command_list '*'  */
+#line 54 "gerber_bison.yy"
+                                                                 { g->processDataBlock(); }
+#line 1424 "gerber_bison.cc"
+    break;
 
-  case 25:
+  case 12: /* paramRS274: PARAMETER_ADD MACRONAME ',' ad_modifier_list  */
+#line 65 "gerber_bison.yy"
+                                                                                             { g->process_AD_block((yyvsp[-3].YS_int));  }
+#line 1430 "gerber_bison.cc"
+    break;
 
-/* Line 1464 of yacc.c  */
-#line 86 "src/gerber_bison.yy"
-  {
-    (yyval.YS_NodeT) = new NodeT(NodeT::VAR, &(yyvsp[(1) - (1)].YS_int), &g->variables);
-  }
-  break;
+  case 13: /* paramRS274: PARAMETER_ADD MACRONAME  */
+#line 66 "gerber_bison.yy"
+                                                                        { g->process_AD_block((yyvsp[-1].YS_int));  }
+#line 1436 "gerber_bison.cc"
+    break;
 
-  case 26:
+  case 14: /* paramRS274: 'S' 'R'  */
+#line 67 "gerber_bison.yy"
+                                                        { g->stepRepeat(1, 1, 0, 0); }
+#line 1442 "gerber_bison.cc"
+    break;
 
-/* Line 1464 of yacc.c  */
-#line 87 "src/gerber_bison.yy"
-  {
-    (yyval.YS_NodeT) = new NodeT(NodeT::CONSTANT, &(yyvsp[(1) - (1)].YS_float));
-  }
-  break;
+  case 15: /* ad_modifier_list: ad_number  */
+#line 69 "gerber_bison.yy"
+                                                                                        { g->variables.push_back((yyvsp[0].YS_float)); }
+#line 1448 "gerber_bison.cc"
+    break;
 
-  case 27:
+  case 16: /* ad_modifier_list: ad_modifier_list 'X' ad_number  */
+#line 70 "gerber_bison.yy"
+                                                                                { g->variables.push_back((yyvsp[0].YS_float)); }
+#line 1454 "gerber_bison.cc"
+    break;
 
-/* Line 1464 of yacc.c  */
-#line 88 "src/gerber_bison.yy"
-  {
-    (yyval.YS_NodeT) = new NodeT(NodeT::OPADD, (yyvsp[(1) - (3)].YS_NodeT), (yyvsp[(3) - (3)].YS_NodeT));
-  }
-  break;
+  case 17: /* ad_modifier_list: ad_modifier_list 'X'  */
+#line 71 "gerber_bison.yy"
+                                                                                        { g->warning("modified expected after X"); }
+#line 1460 "gerber_bison.cc"
+    break;
 
-  case 28:
+  case 18: /* ad_number: '-' NUMBER  */
+#line 73 "gerber_bison.yy"
+                                                   { (yyval.YS_float) = -(yyvsp[0].YS_float); }
+#line 1466 "gerber_bison.cc"
+    break;
 
-/* Line 1464 of yacc.c  */
-#line 89 "src/gerber_bison.yy"
-  {
-    (yyval.YS_NodeT) = new NodeT(NodeT::OPSUB, (yyvsp[(1) - (3)].YS_NodeT), (yyvsp[(3) - (3)].YS_NodeT));
-  }
-  break;
+  case 19: /* ad_number: '+' NUMBER  */
+#line 74 "gerber_bison.yy"
+                                                           { (yyval.YS_float) = (yyvsp[0].YS_float); }
+#line 1472 "gerber_bison.cc"
+    break;
 
-  case 29:
+  case 23: /* am_primitve: NUMBER ',' expr_list  */
+#line 81 "gerber_bison.yy"
+                                        {
+						Aperture primitive;
+						primitive.primitive = Aperture::PRIMITIVE( int((yyvsp[-2].YS_float)) );
+						primitive.parameter.compile(g->temporaryParameters);
+						primitive.nameMacro = g->temporaryNameMacro;
+						primitive.linenum_at_definition = g->currentLine;
+						g->addMacroPrimitive(primitive);
+						g->temporaryParameters.clear();
+					}
+#line 1486 "gerber_bison.cc"
+    break;
 
-/* Line 1464 of yacc.c  */
-#line 90 "src/gerber_bison.yy"
-  {
-    (yyval.YS_NodeT) = new NodeT(NodeT::OPMUL, (yyvsp[(1) - (3)].YS_NodeT), (yyvsp[(3) - (3)].YS_NodeT));
-  }
-  break;
+  case 24: /* expr_list: expr  */
+#line 91 "gerber_bison.yy"
+                                                                        { g->temporaryParameters.push_back((yyvsp[0].YS_NodeT)); }
+#line 1492 "gerber_bison.cc"
+    break;
 
-  case 30:
+  case 25: /* expr_list: expr_list ',' expr  */
+#line 92 "gerber_bison.yy"
+                                                                        { g->temporaryParameters.push_back((yyvsp[0].YS_NodeT)); }
+#line 1498 "gerber_bison.cc"
+    break;
 
-/* Line 1464 of yacc.c  */
-#line 91 "src/gerber_bison.yy"
-  {
-    (yyval.YS_NodeT) = new NodeT(NodeT::OPDIV, (yyvsp[(1) - (3)].YS_NodeT), (yyvsp[(3) - (3)].YS_NodeT));
-  }
-  break;
+  case 26: /* expr: VARIABLE  */
+#line 94 "gerber_bison.yy"
+                                                        { (yyval.YS_NodeT) = g->arena.create<NodeT>(NodeT::VAR		, &(yyvsp[0].YS_int), &g->variables); }
+#line 1504 "gerber_bison.cc"
+    break;
 
-  case 31:
+  case 27: /* expr: NUMBER  */
+#line 95 "gerber_bison.yy"
+                                                                { (yyval.YS_NodeT) = g->arena.create<NodeT>(NodeT::CONSTANT, &(yyvsp[0].YS_float)); }
+#line 1510 "gerber_bison.cc"
+    break;
 
-/* Line 1464 of yacc.c  */
-#line 92 "src/gerber_bison.yy"
-  {
-    (yyval.YS_NodeT) = new NodeT(NodeT::OPNEG, (yyvsp[(2) - (2)].YS_NodeT));
-  }
-  break;
+  case 28: /* expr: expr '+' expr  */
+#line 96 "gerber_bison.yy"
+                                                                { (yyval.YS_NodeT) = g->arena.create<NodeT>(NodeT::OPADD	, (yyvsp[-2].YS_NodeT), (yyvsp[0].YS_NodeT)); }
+#line 1516 "gerber_bison.cc"
+    break;
 
-  case 32:
+  case 29: /* expr: expr '-' expr  */
+#line 97 "gerber_bison.yy"
+                                                                { (yyval.YS_NodeT) = g->arena.create<NodeT>(NodeT::OPSUB	, (yyvsp[-2].YS_NodeT), (yyvsp[0].YS_NodeT)); }
+#line 1522 "gerber_bison.cc"
+    break;
 
-/* Line 1464 of yacc.c  */
-#line 93 "src/gerber_bison.yy"
-  {
-    (yyval.YS_NodeT) = (yyvsp[(2) - (2)].YS_NodeT);
-  }
-  break;
+  case 30: /* expr: expr 'X' expr  */
+#line 98 "gerber_bison.yy"
+                                                                { (yyval.YS_NodeT) = g->arena.create<NodeT>(NodeT::OPMUL	, (yyvsp[-2].YS_NodeT), (yyvsp[0].YS_NodeT)); }
+#line 1528 "gerber_bison.cc"
+    break;
 
-  case 33:
+  case 31: /* expr: expr '/' expr  */
+#line 99 "gerber_bison.yy"
+                                                                { (yyval.YS_NodeT) = g->arena.create<NodeT>(NodeT::OPDIV	, (yyvsp[-2].YS_NodeT), (yyvsp[0].YS_NodeT)); }
+#line 1534 "gerber_bison.cc"
+    break;
 
-/* Line 1464 of yacc.c  */
-#line 94 "src/gerber_bison.yy"
-  {
-    (yyval.YS_NodeT) = (yyvsp[(2) - (3)].YS_NodeT);
-  }
-  break;
+  case 32: /* expr: '-' expr  */
+#line 100 "gerber_bison.yy"
+                                                                                { (yyval.YS_NodeT) = g->arena.create<NodeT>(NodeT::OPNEG, (yyvsp[0].YS_NodeT)); }
+#line 1540 "gerber_bison.cc"
+    break;
 
-  case 36:
+  case 33: /* expr: '+' expr  */
+#line 101 "gerber_bison.yy"
+                                                                                { (yyval.YS_NodeT) = (yyvsp[0].YS_NodeT); }
+#line 1546 "gerber_bison.cc"
+    break;
 
-/* Line 1464 of yacc.c  */
-#line 99 "src/gerber_bison.yy"
-  {
-    g->process_D_command(int((yyvsp[(2) - (2)].YS_float)));
-  }
-  break;
+  case 34: /* expr: '(' expr ')'  */
+#line 102 "gerber_bison.yy"
+                                                                { (yyval.YS_NodeT) = (yyvsp[-1].YS_NodeT); }
+#line 1552 "gerber_bison.cc"
+    break;
 
-  case 37:
+  case 37: /* command: 'D' NUMBER  */
+#line 107 "gerber_bison.yy"
+                                                   { g->process_D_command(int((yyvsp[0].YS_float))); }
+#line 1558 "gerber_bison.cc"
+    break;
 
-/* Line 1464 of yacc.c  */
-#line 100 "src/gerber_bison.yy"
-  {
-    g->process_G_command(int((yyvsp[(2) - (2)].YS_float)));
-  }
-  break;
+  case 38: /* command: 'G' NUMBER  */
+#line 108 "gerber_bison.yy"
+                                                           { g->process_G_command(int((yyvsp[0].YS_float))); }
+#line 1564 "gerber_bison.cc"
+    break;
 
-  case 38:
+  case 39: /* command: 'M' NUMBER  */
+#line 109 "gerber_bison.yy"
+                                                           {  }
+#line 1570 "gerber_bison.cc"
+    break;
 
-/* Line 1464 of yacc.c  */
-#line 101 "src/gerber_bison.yy"
-  {
-  }
-  break;
 
-/* Line 1464 of yacc.c  */
-#line 1588 "src/gerber_bison.cc"
-  default:
-    break;
-  }
-  YY_SYMBOL_PRINT("-> $$ =", yyr1[yyn], &yyval, &yyloc);
+#line 1574 "gerber_bison.cc"
 
-  YYPOPSTACK(yylen);
+      default: break;
+    }
+  /* User semantic actions sometimes alter yychar, and that requires
+     that yytoken be updated with the new translation.  We take the
+     approach of translating immediately before every use of yytoken.
+     One alternative is translating here after every semantic action,
+     but that translation would be missed if the semantic action invokes
+     YYABORT, YYACCEPT, or YYERROR immediately after altering yychar or
+     if it invokes YYBACKUP.  In the case of YYABORT or YYACCEPT, an
+     incorrect destructor might then be invoked immediately.  In the
+     case of YYERROR or YYBACKUP, subsequent parser actions might lead
+     to an incorrect destructor call or verbose syntax error message
+     before the lookahead is translated.  */
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
+
+  YYPOPSTACK (yylen);
   yylen = 0;
-  YY_STACK_PRINT(yyss, yyssp);
 
   *++yyvsp = yyval;
 
-  /* Now `shift' the result of the reduction.  Determine what state
+  /* Now 'shift' the result of the reduction.  Determine what state
      that goes to, based on the state we popped back to and the rule
      number reduced by.  */
-
-  yyn = yyr1[yyn];
-
-  yystate = yypgoto[yyn - YYNTOKENS] + *yyssp;
-  if (0 <= yystate && yystate <= YYLAST && yycheck[yystate] == *yyssp)
-    yystate = yytable[yystate];
-  else
-    yystate = yydefgoto[yyn - YYNTOKENS];
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
 
   goto yynewstate;
 
-/*------------------------------------.
-| yyerrlab -- here on detecting error |
-`------------------------------------*/
+
+/*--------------------------------------.
+| yyerrlab -- here on detecting error.  |
+`--------------------------------------*/
 yyerrlab:
+  /* Make sure we have latest lookahead translation.  See comments at
+     user semantic actions for why this is necessary.  */
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
   /* If not already recovering from an error, report this error.  */
   if (!yyerrstatus)
-  {
-    ++yynerrs;
-#if !YYERROR_VERBOSE
-    yyerror(g, YY_("syntax error"));
-#else
     {
-      YYSIZE_T yysize = yysyntax_error(0, yystate, yychar);
-      if (yymsg_alloc < yysize && yymsg_alloc < YYSTACK_ALLOC_MAXIMUM)
+      ++yynerrs;
       {
-        YYSIZE_T yyalloc = 2 * yysize;
-        if (!(yysize <= yyalloc && yyalloc <= YYSTACK_ALLOC_MAXIMUM))
-          yyalloc = YYSTACK_ALLOC_MAXIMUM;
-        if (yymsg != yymsgbuf)
-          YYSTACK_FREE(yymsg);
-        yymsg = (char *)YYSTACK_ALLOC(yyalloc);
-        if (yymsg)
-          yymsg_alloc = yyalloc;
-        else
-        {
-          yymsg = yymsgbuf;
-          yymsg_alloc = sizeof yymsgbuf;
-        }
-      }
-
-      if (0 < yysize && yysize <= yymsg_alloc)
-      {
-        (void)yysyntax_error(yymsg, yystate, yychar);
-        yyerror(g, yymsg);
-      }
-      else
-      {
-        yyerror(g, YY_("syntax error"));
-        if (yysize != 0)
-          goto yyexhaustedlab;
+        yypcontext_t yyctx
+          = {yyssp, yytoken};
+        char const *yymsgp = YY_("syntax error");
+        int yysyntax_error_status;
+        yysyntax_error_status = yysyntax_error (&yymsg_alloc, &yymsg, &yyctx);
+        if (yysyntax_error_status == 0)
+          yymsgp = yymsg;
+        else if (yysyntax_error_status == -1)
+          {
+            if (yymsg != yymsgbuf)
+              YYSTACK_FREE (yymsg);
+            yymsg = YY_CAST (char *,
+                             YYSTACK_ALLOC (YY_CAST (YYSIZE_T, yymsg_alloc)));
+            if (yymsg)
+              {
+                yysyntax_error_status
+                  = yysyntax_error (&yymsg_alloc, &yymsg, &yyctx);
+                yymsgp = yymsg;
+              }
+            else
+              {
+                yymsg = yymsgbuf;
+                yymsg_alloc = sizeof yymsgbuf;
+                yysyntax_error_status = YYENOMEM;
+              }
+          }
+        yyerror (g, yyscanner, yymsgp);
+        if (yysyntax_error_status == YYENOMEM)
+          YYNOMEM;
       }
     }
-#endif
-  }
 
   if (yyerrstatus == 3)
-  {
-    /* If just tried and failed to reuse lookahead token after an
- error, discard it.  */
-
-    if (yychar <= YYEOF)
     {
-      /* Return failure if at end of input.  */
-      if (yychar == YYEOF)
-        YYABORT;
-    }
-    else
-    {
-      yydestruct("Error: discarding",
-                 yytoken, &yylval, g);
-      yychar = YYEMPTY;
+      /* If just tried and failed to reuse lookahead token after an
+         error, discard it.  */
+
+      if (yychar <= YYEOF)
+        {
+          /* Return failure if at end of input.  */
+          if (yychar == YYEOF)
+            YYABORT;
+        }
+      else
+        {
+          yydestruct ("Error: discarding",
+                      yytoken, &yylval, g, yyscanner);
+          yychar = YYEMPTY;
+        }
     }
-  }
 
   /* Else will try to reuse lookahead token after shifting the error
      token.  */
   goto yyerrlab1;
 
+
 /*---------------------------------------------------.
 | yyerrorlab -- error raised explicitly by YYERROR.  |
 `---------------------------------------------------*/
 yyerrorlab:
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
 
-  /* Pacify compilers like GCC when the user code never invokes
-     YYERROR and the label yyerrorlab therefore never appears in user
-     code.  */
-  if (/*CONSTCOND*/ 0)
-    goto yyerrorlab;
-
-  /* Do not reclaim the symbols of the rule which action triggered
+  /* Do not reclaim the symbols of the rule whose action triggered
      this YYERROR.  */
-  YYPOPSTACK(yylen);
+  YYPOPSTACK (yylen);
   yylen = 0;
-  YY_STACK_PRINT(yyss, yyssp);
+  YY_STACK_PRINT (yyss, yyssp);
   yystate = *yyssp;
   goto yyerrlab1;
 
+
 /*-------------------------------------------------------------.
 | yyerrlab1 -- common code for both syntax error and YYERROR.  |
 `-------------------------------------------------------------*/
 yyerrlab1:
-  yyerrstatus = 3; /* Each real token shifted decrements this.  */
+  yyerrstatus = 3;      /* Each real token shifted decrements this.  */
 
+  /* Pop stack until we find a state that shifts the error token.  */
   for (;;)
-  {
-    yyn = yypact[yystate];
-    if (yyn != YYPACT_NINF)
     {
-      yyn += YYTERROR;
-      if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYTERROR)
-      {
-        yyn = yytable[yyn];
-        if (0 < yyn)
-          break;
-      }
-    }
+      yyn = yypact[yystate];
+      if (!yypact_value_is_default (yyn))
+        {
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
+            {
+              yyn = yytable[yyn];
+              if (0 < yyn)
+                break;
+            }
+        }
 
-    /* Pop the current state because it cannot handle the error token.  */
-    if (yyssp == yyss)
-      YYABORT;
+      /* Pop the current state because it cannot handle the error token.  */
+      if (yyssp == yyss)
+        YYABORT;
 
-    yydestruct("Error: popping",
-               yystos[yystate], yyvsp, g);
-    YYPOPSTACK(1);
-    yystate = *yyssp;
-    YY_STACK_PRINT(yyss, yyssp);
-  }
 
+      yydestruct ("Error: popping",
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp, g, yyscanner);
+      YYPOPSTACK (1);
+      yystate = *yyssp;
+      YY_STACK_PRINT (yyss, yyssp);
+    }
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
   *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
 
   /* Shift the error token.  */
-  YY_SYMBOL_PRINT("Shifting", yystos[yyn], yyvsp, yylsp);
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
 
   yystate = yyn;
   goto yynewstate;
 
+
 /*-------------------------------------.
 | yyacceptlab -- YYACCEPT comes here.  |
 `-------------------------------------*/
 yyacceptlab:
   yyresult = 0;
-  goto yyreturn;
+  goto yyreturnlab;
+
 
 /*-----------------------------------.
 | yyabortlab -- YYABORT comes here.  |
 `-----------------------------------*/
 yyabortlab:
   yyresult = 1;
-  goto yyreturn;
+  goto yyreturnlab;
 
-#if !defined(yyoverflow) || YYERROR_VERBOSE
-/*-------------------------------------------------.
-| yyexhaustedlab -- memory exhaustion comes here.  |
-`-------------------------------------------------*/
+
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
 yyexhaustedlab:
-  yyerror(g, YY_("memory exhausted"));
+  yyerror (g, yyscanner, YY_("memory exhausted"));
   yyresult = 2;
-  /* Fall through.  */
-#endif
+  goto yyreturnlab;
 
-yyreturn:
+
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
   if (yychar != YYEMPTY)
-    yydestruct("Cleanup: discarding lookahead",
-               yytoken, &yylval, g);
-  /* Do not reclaim the symbols of the rule which action triggered
+    {
+      /* Make sure we have latest lookahead translation.  See comments at
+         user semantic actions for why this is necessary.  */
+      yytoken = YYTRANSLATE (yychar);
+      yydestruct ("Cleanup: discarding lookahead",
+                  yytoken, &yylval, g, yyscanner);
+    }
+  /* Do not reclaim the symbols of the rule whose action triggered
      this YYABORT or YYACCEPT.  */
-  YYPOPSTACK(yylen);
-  YY_STACK_PRINT(yyss, yyssp);
+  YYPOPSTACK (yylen);
+  YY_STACK_PRINT (yyss, yyssp);
   while (yyssp != yyss)
-  {
-    yydestruct("Cleanup: popping",
-               yystos[*yyssp], yyvsp, g);
-    YYPOPSTACK(1);
-  }
+    {
+      yydestruct ("Cleanup: popping",
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, g, yyscanner);
+      YYPOPSTACK (1);
+    }
 #ifndef yyoverflow
   if (yyss != yyssa)
-    YYSTACK_FREE(yyss);
+    YYSTACK_FREE (yyss);
 #endif
-#if YYERROR_VERBOSE
   if (yymsg != yymsgbuf)
-    YYSTACK_FREE(yymsg);
-#endif
-  /* Make sure YYID is used.  */
-  return YYID(yyresult);
+    YYSTACK_FREE (yymsg);
+  return yyresult;
 }
 
-/* Line 1684 of yacc.c  */
-#line 107 "src/gerber_bison.yy"
+#line 115 "gerber_bison.yy"
+
+
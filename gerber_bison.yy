@@ -16,10 +16,16 @@
 };
 
 
+%code provides
+{
+	extern int yylex(YYSTYPE *yylval_param, Gerber *g, yyscan_t yyscanner);
+}
+
 %defines
-%parse-param {Gerber *g}
-%lex-param {Gerber *g}
-%error-verbose
+%define api.pure full
+%parse-param {Gerber *g} {yyscan_t yyscanner}
+%lex-param {Gerber *g} {yyscan_t yyscanner}
+%define parse.error verbose
 %token-table
 
 %token <YS_int> PARAMETER_ADD
@@ -58,6 +64,7 @@ paramRS274_list		:	paramRS274 asterisk
 paramRS274 			:	PARAMETER
 					|	PARAMETER_ADD MACRONAME ',' ad_modifier_list { g->process_AD_block($1);  }
 					|	PARAMETER_ADD MACRONAME { g->process_AD_block($1);  }
+					|	'S' 'R' { g->stepRepeat(1, 1, 0, 0); }			// SR without parameters ends a step and repeat block
 
 ad_modifier_list 	:	ad_number						{ g->variables.push_back($1); }
 					|	ad_modifier_list 'X' ad_number	{ g->variables.push_back($3); }
@@ -72,24 +79,25 @@ am_primitive_list	: 	asterisk am_primitve
 
 am_primitve			: 	NUMBER ',' expr_list
 					{
-						g->macro_apertures.push_back(Aperture());
-						g->macro_apertures.back().primitive = Aperture::PRIMITIVE( int($1) );
-						g->macro_apertures.back().parameter = g->temporaryParameters;
-						g->macro_apertures.back().nameMacro = g->temporaryNameMacro;
-						g->macro_apertures.back().linenum_at_definition = g->currentLine;
+						Aperture primitive;
+						primitive.primitive = Aperture::PRIMITIVE( int($1) );
+						primitive.parameter.compile(g->temporaryParameters);
+						primitive.nameMacro = g->temporaryNameMacro;
+						primitive.linenum_at_definition = g->currentLine;
+						g->addMacroPrimitive(primitive);
 						g->temporaryParameters.clear();
 					}
 
 expr_list 			:  	expr				{ g->temporaryParameters.push_back($1); }
 					|  	expr_list ',' expr	{ g->temporaryParameters.push_back($3); }
 
-expr				: 	VARIABLE  	{ $$ = new NodeT(NodeT::VAR		, &$1, &g->variables); }
-					| 	NUMBER		{ $$ = new NodeT(NodeT::CONSTANT, &$1); }
-					| 	expr '+' expr	{ $$ = new NodeT(NodeT::OPADD	, $1, $3); }
-					| 	expr '-' expr	{ $$ = new NodeT(NodeT::OPSUB	, $1, $3); }
-					| 	expr 'X' expr	{ $$ = new NodeT(NodeT::OPMUL	, $1, $3); }
-					| 	expr '/' expr	{ $$ = new NodeT(NodeT::OPDIV	, $1, $3); }
-					| 	'-' expr 	%prec UNARY	{ $$ = new NodeT(NodeT::OPNEG, $2); }
+expr				: 	VARIABLE  	{ $$ = g->arena.create<NodeT>(NodeT::VAR		, &$1, &g->variables); }
+					| 	NUMBER		{ $$ = g->arena.create<NodeT>(NodeT::CONSTANT, &$1); }
+					| 	expr '+' expr	{ $$ = g->arena.create<NodeT>(NodeT::OPADD	, $1, $3); }
+					| 	expr '-' expr	{ $$ = g->arena.create<NodeT>(NodeT::OPSUB	, $1, $3); }
+					| 	expr 'X' expr	{ $$ = g->arena.create<NodeT>(NodeT::OPMUL	, $1, $3); }
+					| 	expr '/' expr	{ $$ = g->arena.create<NodeT>(NodeT::OPDIV	, $1, $3); }
+					| 	'-' expr 	%prec UNARY	{ $$ = g->arena.create<NodeT>(NodeT::OPNEG, $2); }
 					| 	'+' expr 	%prec UNARY	{ $$ = $2; }
 					| 	'(' expr ')'	{ $$ = $2; }
 
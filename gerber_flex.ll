@@ -4,17 +4,12 @@
 
 %{
 #include <string.h>
+#include <charconv>
 #include "./gerber.h"
 #include "gerber_bison.h"
 
 
-#define YY_DECL 	int yylex(Gerber *g)
-
-#define YY_USER_ACTION  \
-	if (g->repeat.X > 1 && g->repeat.Y > 1) \
-	{ \
-		g->repeat.buffer += yytext; \
-	}
+#define YY_DECL 	int yylex(YYSTYPE *yylval_param, Gerber *g, yyscan_t yyscanner)
 
 /*  
  *
@@ -35,6 +30,8 @@ void numberAfterChar(const char * str, char c, double *data, double multiplier=1
 %option 	stack
 %option 	noyywrap
 %option 	posix-compat
+%option 	reentrant
+%option 	bison-bridge
 
 /* A condition when extracting aperture macro names
  * The AMblock condition is required so send arithmatic operators  '+', '-', 'X' and '/' to the parser
@@ -55,28 +52,29 @@ void numberAfterChar(const char * str, char c, double *data, double multiplier=1
 <*>\n							{	g->currentLine++;					// count the LF and hide from parser
 							}
 <INITIAL,ADblock,AMblock>[0-9]*\.?[0-9]+\.?[0-9]*	{				// get floating point number, and extract extranous '.' followed by digits.
-								yylval.YS_float   = atof(yytext);	// Evaluate number but ignore '+' or '-' prefix as it handler in yylex()
+								yylval->YS_float = 0;				// Evaluate number but ignore '+' or '-' prefix as it handler in yylex()
+								std::from_chars(yytext, yytext + yyleng, yylval->YS_float);	// locale independent, stops before an extraneous '.'
 								if (strchr(yytext,'.') != strrchr(yytext,'.') )  g->warning("extraneous '.' in number");
 								return NUMBER;
 							}
 <AMblock>\$[0-9]+			{
-								yylval.YS_int  = atoi(yytext+1)-1;		// $n Variables identifiers
-								if (yylval.YS_int < 0 ) throw string("variable placeholder must be >= 1");
+								yylval->YS_int  = atoi(yytext+1)-1;		// $n Variables identifiers
+								if (yylval->YS_int < 0 ) throw string("variable placeholder must be >= 1");
 								return VARIABLE;
 							}
-AM							{	yy_push_state(macroname);				// AM paramater syntax
+AM							{	yy_push_state(macroname, yyscanner);				// AM paramater syntax
 								BEGIN(AMblock);							// goto <AMblock> condition, exits on next '%' tocken, see below
-								yy_push_state(macroname);
+								yy_push_state(macroname, yyscanner);
 								return PARAMETER_AM;
 							}
-ADD[0-9]+  					{	yylval.YS_int = atoi(yytext+3);		// ADD paramater syntax (return D code in value)
+ADD[0-9]+  					{	yylval->YS_int = atoi(yytext+3);		// ADD paramater syntax (return D code in value)
 								BEGIN(ADblock);					// goto <ADblock> condition, exits on next '*' tocken, see below
-								yy_push_state(macroname);
+								yy_push_state(macroname, yyscanner);
 								return PARAMETER_ADD;
 							}
 <macroname>[A-Za-z_]+[A-Za-z_0-9]*	{								// a string of the Aperture macro name
 								g->temporaryNameMacro = yytext;				// save string
-								yy_pop_state();
+								yy_pop_state(yyscanner);
 								return MACRONAME;
 							}
 FS.*X[0-9][0-9].*Y[0-9][0-9] 	{  							// FS Format Statement
@@ -86,13 +84,14 @@ FS.*X[0-9][0-9].*Y[0-9][0-9] 	{  							// FS Format Statement
 								g->coordsDecimals[0] = *(strchr(yytext,'X')+2) - '0';
 								g->coordsInts[1] = *(strchr(yytext,'Y')+1) - '0';
 								g->coordsDecimals[1] = *(strchr(yytext,'Y')+2) - '0';
+								g->updateCoordinateScale();
 								return PARAMETER;
 							}
 IF[^*]+\*					{															// IF, Include file.  Don't return to parser
 								yytext[yyleng-1]=0;			// remove trailing '*'
 								yyin = fopen(yytext+2,"r");
 								if ( ! yyin)	throw string("cannot open include file '")+(yytext+2)+"'";
-								yypush_buffer_state(yy_create_buffer( yyin, YY_BUF_SIZE ));
+								yypush_buffer_state(yy_create_buffer( yyin, YY_BUF_SIZE, yyscanner ), yyscanner);
 							}
 G0*4[^*]*					{	return CODE; }											// G04 command. Skip remainder of data block.
 ASAXBY						{	g->isAxisSwapped = false; return PARAMETER; }			// Axis Swap
@@ -100,19 +99,13 @@ ASAYBX						{	g->isAxisSwapped = true;
 								g->warning("Ignoring AS (Axis Swap) parameter. A axis = X data, B axis = Y data.");
 								return PARAMETER;
 							}
-SR([XYIJ][-+]?[0-9]*\.?[0-9]+)+ 	{
-//							cout << "\nlast SR block "<<g->repeat.buffer<<"\n";
-							g->repeat.I = 0;
-							g->repeat.J = 0;
-							double x=1,y=1;
+SR([XYIJ][-+]?[0-9]*\.?[0-9]+)+ 	{									// Step and Repeat, the block ends at the next SR parameter
+							double x=1,y=1,i=0,j=0;
 							numberAfterChar(yytext, 'X', &x);
 							numberAfterChar(yytext, 'Y', &y);
-							g->repeat.X = int(x);
-							g->repeat.Y = int(y);
-							numberAfterChar(yytext, 'I', &g->repeat.I);
-							numberAfterChar(yytext, 'J', &g->repeat.J);
-							g->repeat.buffer.erase();
-							g->warning("Ignoring SR (Step and Repeat) parameter");
+							numberAfterChar(yytext, 'I', &i);
+							numberAfterChar(yytext, 'J', &j);
+							g->stepRepeat(int(x), int(y), i, j);
 							return PARAMETER;
 							}
 
@@ -122,8 +115,8 @@ LPD							{ 	g->layerPolarityClear = false;  return PARAMETER; }		// Layer Polar
 LPC							{ 	g->layerPolarityClear = true; return PARAMETER; }		// Layer Polarity (draw clear)
 IPPOS						{	g->imagePolarityDark = true; return PARAMETER; }		// Image Polarity set to dark
 IPNEG						{	g->imagePolarityDark = false; return PARAMETER; }		// Image Polarity set to clear
-MOIN						{ 	g->units = Gerber::INCH;  return PARAMETER; }  					// assign dimensions in inches 
-MOMM						{ 	g->units = Gerber::MILLIMETER; return PARAMETER; }				// assign dimensions in millimetres
+MOIN						{ 	g->units = Gerber::INCH; g->updateCoordinateScale(); return PARAMETER; }  					// assign dimensions in inches 
+MOMM						{ 	g->units = Gerber::MILLIMETER; g->updateCoordinateScale(); return PARAMETER; }				// assign dimensions in millimetres
 MI(A[01])?(B[01])?			{	bool preA = g->isMirrorAaxis;							// specify mirroring of A axis and/or B axis
 								bool preB = g->isMirrorBaxis;
 								if (strstr(yytext, "A0") != 0) g->isMirrorAaxis = false;
@@ -165,7 +158,7 @@ PF[^*]*						{	g->imageFilm = yytext[2]; return PARAMETER; 	}		// Image Film str
 <*>[A-Za-z0-9\+%\-/(),\*]	{	return toupper(yytext[0]); }							// return all other valid single characters
 <*>.						{ }															// ignore all invalid characters
 <<EOF>> 					{
-								yypop_buffer_state();
+								yypop_buffer_state(yyscanner);
 								if ( !YY_CURRENT_BUFFER )
 								{
 									yyterminate();
@@ -8,6 +8,7 @@
 #include <list>
 #include <map>
 #include <string>
+#include <memory>
 #include <math.h>
 #include <limits.h>
 #include <ctype.h>
@@ -23,15 +24,19 @@ using json = nlohmann::json;
 
 #include "polygon.h"
 #include "apertures.h"
+#include "compression.h"
 #include "gerber.h"
+#include "rasterizer.h"
+#include "row_runs.h"
+#include "span_fill.h"
 #include "tiffio.h"
 #include "EasyBMP/EasyBMP.h"
 #include "error_codes.h"
+#include "mapped_file.h"
+#include "parallel.h"
 
 unsigned char *DEGUB_bitmap_ptr_end;
 
-unsigned char nbitsTable[256];
-
 const char *help_message =
 	"Gerber RS-274X file to raster graphics converter.";
 
@@ -56,101 +61,6 @@ double total_area_cmsq = 0;
 double optGrowSize = 0;
 double optScaleX = 1;
 double optScaleY = 1;
-unsigned int bytesPerScanline;
-unsigned int bitmapBytes;
-unsigned char *bitmap;
-
-//**********************************************************
-// Optimised horizontal line drawing from x1,y to x2,y in the monochrome bitmap
-// polarity specifies how pixels are changed.
-// DRAW_ON = line is drawn bits set
-// DRAW_OFF = line is drawn bits cleared
-// DRAW_REVERSE  = line is drawn bits inverted
-//
-// global dependencies:	bytesPerScanline, bitmap
-//**********************************************************
-void horizontalLine(int x1, int x2, unsigned char *buffer, Polarity_t polarity)
-{
-	if (x1 > x2)
-		std::swap(x1, x2);
-
-	static unsigned char fillSingle[64] = {
-		0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-		0xC0, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-		0xE0, 0x60, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00,
-		0xF0, 0x70, 0x30, 0x10, 0x00, 0x00, 0x00, 0x00,
-		0xF8, 0x78, 0x38, 0x18, 0x08, 0x00, 0x00, 0x00,
-		0xFC, 0x7C, 0x3C, 0x1C, 0x0C, 0x04, 0x00, 0x00,
-		0xFE, 0x7E, 0x3E, 0x1E, 0x0E, 0x06, 0x02, 0x00,
-		0xFF, 0x7F, 0x3F, 0x1F, 0x0F, 0x07, 0x03, 0x01};
-
-	static unsigned char fillLast[8] = {0x80, 0xC0, 0xE0, 0xF0, 0xF8, 0xFC, 0xFE, 0xFF};
-	static unsigned char fillFirst[8] = {0xFF, 0x7F, 0x3F, 0x1F, 0x0F, 0x07, 0x03, 0x01};
-
-	const unsigned char b1 = static_cast<unsigned char>(x1 & 7);
-	const unsigned char b2 = static_cast<unsigned char>(x2 & 7);
-
-	unsigned char *px1 = buffer + (x1 >> 3);
-	unsigned char *px2 = buffer + (x2 >> 3);
-
-	// left pixel = MSB
-	// right pixel = LSB
-	switch (polarity)
-	{
-	case DARK: // plot line with set bits
-		// fill in the pixels at the byte x1, and x2 occupy.
-		if (px1 == px2)
-		{ // x1 and x2 occupy the same  byte
-			*px1 |= fillSingle[b1 + (b2 << 3)];
-		}
-		else
-		{ // x1 and x2 occupy different bytes
-			*px1 |= fillFirst[b1];
-			*px2 |= fillLast[b2];
-			// fill only the whole bytes in buffer between x1 and x2
-			px1++;
-			memset(px1, 0xFF, (px2 - px1));
-		}
-		break;
-
-	case CLEAR: // plot line with cleared bits
-
-		if (px1 == px2) // fill in the pixels at the byte x1, and x2 occupy.
-		{				// x1 and x2 occupy the same  byte
-			*px1 &= ~fillSingle[b1 + (b2 << 3)];
-		}
-		else
-		{ // x1 and x2 occupy different bytes
-			*px1 &= ~fillFirst[b1];
-			*px2 &= ~fillLast[b2];
-			// fill only the whole bytes in buffer between x1 and x2
-			px1++;
-			memset(px1, 0x0, (px2 - px1));
-		}
-		break;
-
-	case XOR: // invert the pixels
-		// fill in the pixels at the byte x1, and x2 occupy.
-		if (px1 == px2)
-		{ // x1 and x2 occupy the same  byte
-			*px1 ^= fillSingle[b1 + (b2 << 3)];
-		}
-		else
-		{ // x1 and x2 occupy different bytes
-			*px1 ^= fillFirst[b1];
-			*px2 ^= fillLast[b2];
-			// XOR only the whole bytes in buffer between x1 and x2 (exclusive)
-			px1++;
-			while (px1 < px2)
-			{
-				*px1 ^= 0xFF;
-				px1++;
-			}
-		}
-		break;
-	}
-
-} // end HorizontalLine()
 
 std::string normalizePathToDoubleBackslashes(const std::string &path)
 {
@@ -160,7 +70,12 @@ std::string normalizePathToDoubleBackslashes(const std::string &path)
 }
 
 //**********************************************************
-extern "C" __declspec(dllexport) int __stdcall processGerber(
+// Common body of the exported functions. The Gerber data is read from the file
+// inputFilename, or from memory at inputData when inputData is not null.
+// threads is the number of threads preparing the polygons and drawing the TIFF strips, 0 for one per processor.
+// codec is the TIFF compression.
+//**********************************************************
+static int renderGerber(
 	double imageDPI,
 	bool optGrowUnitsMillimeters,
 	bool optBoarderUnitsMillimeters,
@@ -171,13 +86,17 @@ extern "C" __declspec(dllexport) int __stdcall processGerber(
 	double optScaleX,
 	double optScaleY,
 	const char *outputFilename,
-	const char *inputFilename)
+	const char *inputFilename,
+	const char *inputData,
+	size_t inputSize,
+	unsigned threads,
+	Codec_t codec)
 {
 	try
 	{
 		clock_t start_time = std::clock(); // Начало измерения времени
 
-		if (!outputFilename || !inputFilename)
+		if (!outputFilename || (!inputFilename && !inputData))
 		{
 			return ERROR_INVALID_PARAMETERS; // код ошибки: некорректные параметры
 		}
@@ -195,11 +114,13 @@ extern "C" __declspec(dllexport) int __stdcall processGerber(
 				  << "optScaleX: " << optScaleX << "\n"
 				  << "optScaleY: " << optScaleY << "\n"
 				  << "outputFilename: " << (outputFilename ? outputFilename : "null") << "\n"
-				  << "inputFilename: " << (inputFilename ? inputFilename : "null");
+				  << "inputFilename: " << (inputFilename ? inputFilename : "null") << "\n"
+				  << "threads: " << threads << "\n"
+				  << "compression: " << codec;
 
 		// Нормализация путей
 		std::string normalizedOutputFilename = normalizePathToDoubleBackslashes(outputFilename);
-		std::string normalizedInputFilename = normalizePathToDoubleBackslashes(inputFilename);
+		std::string normalizedInputFilename = inputData ? std::string("<memory>") : normalizePathToDoubleBackslashes(inputFilename);
 
 		if (normalizedOutputFilename.empty() || normalizedInputFilename.empty())
 		{
@@ -212,13 +133,6 @@ extern "C" __declspec(dllexport) int __stdcall processGerber(
 		for (size_t i = 0; i < normalizedInputFilename.size(); i++)
 			normalizedInputBytes << std::hex << static_cast<int>(static_cast<unsigned char>(normalizedInputFilename[i])) << " ";
 
-		// Проверка входного файла
-		FILE *file = fopen(normalizedInputFilename.c_str(), "rb");
-		if (file == NULL)
-		{
-			return ERROR_FILE_OPEN_FAILED;
-		}
-
 		if (normalizedOutputFilename.empty())
 			normalizedOutputFilename = normalizedInputFilename + ".tiff";
 
@@ -229,25 +143,44 @@ extern "C" __declspec(dllexport) int __stdcall processGerber(
 						<< "optScaleX: " << optScaleX << "\n"
 						<< "optScaleY: " << optScaleY;
 
-		std::list<Gerber *> gerbers;
-		try
-		{
-
-			gerbers.push_back(new Gerber(file, imageDPI, optGrowSize, optScaleX, optScaleY));
-		}
-		catch (const std::exception &e)
+		std::list<std::unique_ptr<Gerber> > gerbers; // deleting a Gerber releases all its geometry at once
+		if (inputData)
 		{
-
-			fclose(file);
-			return ERROR_GERBER_PROCESSING; // код ошибки: ошибка обработки Gerber
+			try
+			{
+				gerbers.push_back(std::unique_ptr<Gerber>(new Gerber(inputData, inputSize, imageDPI, optGrowSize, optScaleX, optScaleY, threads)));
+			}
+			catch (const std::exception &e)
+			{
+				return ERROR_GERBER_PROCESSING; // код ошибки: ошибка обработки Gerber
+			}
+			catch (...)
+			{
+				return ERROR_GERBER_PROCESSING; // код ошибки: ошибка обработки Gerber
+			}
 		}
-		catch (...)
+		else
 		{
+			// Проверка входного файла
+			MappedFile file(normalizedInputFilename.c_str());
+			if (!file.isOpen())
+			{
+				return ERROR_FILE_OPEN_FAILED;
+			}
 
-			fclose(file);
-			return ERROR_GERBER_PROCESSING; // код ошибки: ошибка обработки Gerber
+			try
+			{
+				gerbers.push_back(std::unique_ptr<Gerber>(new Gerber(file, imageDPI, optGrowSize, optScaleX, optScaleY, threads)));
+			}
+			catch (const std::exception &e)
+			{
+				return ERROR_GERBER_PROCESSING; // код ошибки: ошибка обработки Gerber
+			}
+			catch (...)
+			{
+				return ERROR_GERBER_PROCESSING; // код ошибки: ошибка обработки Gerber
+			}
 		}
-		fclose(file);
 
 		// Вывод предупреждений
 		for (std::size_t i = 0; i < gerbers.back()->messages.size(); i++)
@@ -264,28 +197,6 @@ extern "C" __declspec(dllexport) int __stdcall processGerber(
 			return ERROR_GERBER_PROCESSING; // код ошибки: ошибка обработки Gerber
 		}
 
-		// Создание таблицы для подсчета битов
-		for (int i = 0; i < 256; i++)
-		{
-			nbitsTable[i] = 0;
-			if ((i & 0x01))
-				nbitsTable[i]++;
-			if ((i & 0x02))
-				nbitsTable[i]++;
-			if ((i & 0x04))
-				nbitsTable[i]++;
-			if ((i & 0x08))
-				nbitsTable[i]++;
-			if ((i & 0x10))
-				nbitsTable[i]++;
-			if ((i & 0x20))
-				nbitsTable[i]++;
-			if ((i & 0x40))
-				nbitsTable[i]++;
-			if ((i & 0x80))
-				nbitsTable[i]++;
-		}
-
 		if (imageDPI < 1 || optBoarder < 0)
 		{
 			std::cerr << "Error: invalid DPI or border parameters." << std::endl;
@@ -298,35 +209,24 @@ extern "C" __declspec(dllexport) int __stdcall processGerber(
 		if (optBoarderUnitsMillimeters)
 			optBoarder *= imageDPI / 25.4;
 
-		int miny = INT_MAX; // holds min and max dimentions of the occupied gerber images (superimposed)
-		int minx = INT_MAX;
-		int maxy = INT_MIN;
-		int maxx = INT_MIN;
-		std::list<Polygon> globalPolygons; // Contains polygons created by the all gerbers.
+		Rasterizer rasterizer(threads);
 
-		for (std::list<Gerber *>::iterator it = gerbers.begin(); it != gerbers.end(); it++)
+		for (std::list<std::unique_ptr<Gerber> >::iterator it = gerbers.begin(); it != gerbers.end(); it++)
 		{
-			globalPolygons.merge((*it)->polygons);
+			rasterizer.add(**it);
 		}
 
-		if (globalPolygons.size() == 0)
+		if (rasterizer.empty())
 		{ // Если нечего рисовать, завершить с ошибкой
 
 			return ERROR_NO_IMAGE; // код ошибки: нет изображения
 		}
 
-		// find extreme (x,y) coordinates for all polygons
-		for (std::list<Polygon>::iterator it = globalPolygons.begin(); it != globalPolygons.end(); it++)
-		{
-			if (minx > it->pixelMinX)
-				minx = it->pixelMinX;
-			if (maxx < it->pixelMaxX)
-				maxx = it->pixelMaxX;
-			if (miny > it->pixelMinY)
-				miny = it->pixelMinY;
-			if (maxy < it->pixelMaxY)
-				maxy = it->pixelMaxY;
-		}
+		// holds min and max dimentions of the occupied gerber images (superimposed)
+		int miny = rasterizer.miny;
+		int minx = rasterizer.minx;
+		int maxy = rasterizer.maxy;
+		int maxx = rasterizer.maxx;
 
 		// use the world coordinate limits <maxx, minx, maxx, minx> to determine the
 		// sized  of the bitmap buffer to allocate for drawing the image
@@ -378,35 +278,26 @@ extern "C" __declspec(dllexport) int __stdcall processGerber(
 
 			// Draw polygons
 			xOffset -= minx;
-			for (std::list<Polygon>::iterator it = globalPolygons.begin(); it != globalPolygons.end(); it++)
+			for (int y = miny; y <= maxy; y++)
 			{
-				Polarity_t pol = it->polarity;
-				if ((pol == DARK) && !isPolarityDark)
-					pol = CLEAR;
-				if ((pol == CLEAR) && isPolarityDark)
-					pol = DARK;
-
-				int sliCount;
-				int *sliTable;
-				for (int y = it->pixelMinY; y <= it->pixelMaxY; y++)
+				rasterizer.scanLine(y, [&](int x1, int x2, Polarity_t pol)
 				{
-					it->getNextLineX1X2Pairs(sliTable, sliCount);
-					for (int i = 0; i < sliCount; i += 2)
+					if ((pol == DARK) && !isPolarityDark)
+						pol = CLEAR;
+					if ((pol == CLEAR) && isPolarityDark)
+						pol = DARK;
+
+					for (int x = xOffset + x1; x <= xOffset + x2; x++)
 					{
-						for (int x = xOffset + it->pixelOffsetX + sliTable[i];
-							 x <= xOffset + it->pixelOffsetX + sliTable[i + 1];
-							 x++)
+						if (x >= 0 && x < (int)imageWidth &&
+							(y - miny + yOffset) >= 0 &&
+							(y - miny + yOffset) < (int)imageHeight)
 						{
-							if (x >= 0 && x < (int)imageWidth &&
-								(y - miny + yOffset) >= 0 &&
-								(y - miny + yOffset) < (int)imageHeight)
-							{
-								output.SetPixel(x, y - miny + yOffset,
-												(pol == DARK) ? black : white);
-							}
+							output.SetPixel(x, y - miny + yOffset,
+											(pol == DARK) ? black : white);
 						}
 					}
-				}
+				});
 			}
 
 			// Write BMP file
@@ -430,92 +321,142 @@ extern "C" __declspec(dllexport) int __stdcall processGerber(
 
 			TIFFSetField(tif, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);	// avoid errors, dispite TIFF spec saying this tag not needed in monochrome images.
 			TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_MINISWHITE); // white pixels are zero
-			TIFFSetField(tif, TIFFTAG_COMPRESSION, COMPRESSION_CCITTRLE);	// use CCITT Group 3 1-Dimensional Modified Huffman run length encoding
+			TIFFSetField(tif, TIFFTAG_COMPRESSION, tiffCompression(codec)); // CCITT Group 3 1-Dimensional Modified Huffman run length encoding by default
 			TIFFSetField(tif, TIFFTAG_IMAGELENGTH, imageHeight);
 			TIFFSetField(tif, TIFFTAG_IMAGEWIDTH, imageWidth);
 			TIFFSetField(tif, TIFFTAG_RESOLUTIONUNIT, 2); // Resulution unit in inches
 			TIFFSetField(tif, TIFFTAG_YRESOLUTION, imageDPI);
 			TIFFSetField(tif, TIFFTAG_XRESOLUTION, imageDPI);
-			TIFFSetField(tif, TIFFTAG_ROWSPERSTRIP, rowsPerStrip);
+			TIFFSetField(tif, TIFFTAG_ROWSPERSTRIP, codec == CODEC_JBIG ? imageHeight : rowsPerStrip); // libtiff reads JBIG as one strip only
 
 			//
-			// Calculate size and allocate buffer for drawing. The image will be rendered sequential blocks of
-			// imageWidth wide by rowsPerStrip high.
+			// Calculate size and allocate buffers for drawing. The image will be rendered in blocks of
+			// imageWidth wide by rowsPerStrip high, several at a time with more than one thread. Each block has
+			// its own bitmap and compressed data buffer, reused by every window'th strip. CCITT strips are
+			// encoded straight from the spans of each row instead, and need no bitmap.
 			//
-			bytesPerScanline = ((imageWidth + 7) >> 3);
-			bitmapBytes = bytesPerScanline * rowsPerStrip;
-			bitmap = (unsigned char *)std::malloc(bitmapBytes);
-			if (bitmap == 0)
+			unsigned stripCount = (imageHeight + rowsPerStrip - 1) / rowsPerStrip;
+			size_t window = threadCount(threads) > 1 ? std::min<size_t>(stripCount, 2 * threadCount(threads)) : 1; // strips in flight
+			std::vector<Rasterizer::Strip> strips(window);
+			std::vector<StripEncoder> encoders(window, StripEncoder(codec));
+			bool isDrawnByRows = encoders[0].encodesRows();
+			unsigned bytesPerScanline = ((imageWidth + 7) >> 3);
+			unsigned bitmapBytes = isDrawnByRows ? 0 : bytesPerScanline * rowsPerStrip;
+			unsigned char *bitmap = 0;
+			if (!isDrawnByRows && (bitmap = (unsigned char *)std::malloc(window * bitmapBytes)) == 0)
 			{
+				TIFFClose(tif);
 				std::cerr << "Error: memory allocation failed." << std::endl;
 				return ERROR_MEMORY_ALLOCATION; // код ошибки: ошибка выделения памяти
 			}
+			std::vector<RowRuns> rows(isDrawnByRows ? window : 0);
+			std::vector<RowPainter> painters(isDrawnByRows ? 0 : window);
+			std::unique_ptr<JbigEncoder> jbig(codec == CODEC_JBIG ? new JbigEncoder(imageWidth, imageHeight) : 0);
 
 			//-----------------------------------------------------------------------
 			// Draw polygons
 			//-----------------------------------------------------------------------
 			xOffset -= minx;
 
-			int stripCounter = 0;
-			std::list<Polygon>::iterator polyIterator = globalPolygons.begin();
-			std::list<PolygonReference> activePolys;
-
-			// The bitmap will be divided into strips, of height rowsPerStrip.
-			// Polygons are plotted for each strip consecutively in a loop, where the strip y coordinate equals ystart
-			for (int ystart = miny - yOffset; ystart < (int(imageHeight) + miny - yOffset); ystart += rowsPerStrip)
+			// The bitmap is divided into strips of height rowsPerStrip, where the strip y coordinate equals ystart.
+			// The strips are set up in order, drawn and compressed by the worker threads each in their own buffer,
+			// and written to the TIFF in order. A JBIG image is compressed while writing instead, as a single stream.
+			try
 			{
-				// blank entire strip buffer, set pixels on/off depending on polarity of the 1st Gerber.
-				if (isPolarityDark)
-					memset(bitmap, 0x00, bitmapBytes);
-				else
-					memset(bitmap, 0xff, bitmapBytes);
-
-				unsigned char *bufferLine = bitmap;
-
-				// Loop over each row of the strip and fill with horizontal lines from the polygon raster data.
-				// All polygon are sorted in the list globalPolygons. Iterating each polygon for raster data will guarantee no missing lines.
-				for (int y = ystart; (y - ystart) < static_cast<int>(rowsPerStrip) && (y <= maxy); y++, bufferLine += bytesPerScanline)
+				parallelPipeline(stripCount, threads, window, [&](size_t strip)
+				{
+					int ystart = miny - yOffset + int(strip * rowsPerStrip);
+					rasterizer.prepare(ystart, std::min(ystart + int(rowsPerStrip) - 1, maxy), strips[strip % window]);
+				},
+				[&](size_t strip)
 				{
-					while (polyIterator != globalPolygons.end() && y == (polyIterator->pixelMinY))
+					int ystart = miny - yOffset + int(strip * rowsPerStrip);
+					unsigned lines = std::min(rowsPerStrip, imageHeight - rowsPerStrip * unsigned(strip));
+					if (isDrawnByRows)
 					{
-						activePolys.push_back(PolygonReference());
-						activePolys.back().polygon = &(*polyIterator);
-						activePolys.sort();
-						polyIterator++;
+						// Draw each row of the strip as its changing pixels and encode it right away, all rows
+						// starting in the colour of the 1st Gerber's polarity.
+						RowRuns &row = rows[strip % window];
+						StripEncoder &encoder = encoders[strip % window];
+						encoder.beginStrip();
+						for (unsigned i = 0; i < lines; i++)
+						{
+							int y = ystart + int(i);
+							row.reset(int(imageWidth), !isPolarityDark);
+							if (y <= maxy)
+							{
+								strips[strip % window].scanLine(y, [&](int x1, int x2, Polarity_t pol)
+								{
+									if ((pol == DARK) && !isPolarityDark)
+										pol = CLEAR;
+									if ((pol == CLEAR) && isPolarityDark)
+										pol = DARK;
+									row.draw(xOffset + x1, xOffset + x2, pol);
+								});
+							}
+							encoder.encodeRow(row.data(), row.size(), imageWidth);
+						}
+						encoder.endStrip();
+						return;
 					}
 
-					for (std::list<PolygonReference>::iterator it = activePolys.begin(); it != activePolys.end();)
+					unsigned char *buffer = bitmap + strip % window * bitmapBytes;
+
+					// blank entire strip buffer, set pixels on/off depending on polarity of the 1st Gerber.
+					if (isPolarityDark)
+						memset(buffer, 0x00, bitmapBytes);
+					else
+						memset(buffer, 0xff, bitmapBytes);
+
+					// Loop over each row of the strip and fill with horizontal lines from the polygon raster data.
+					// The rasterizer returns the spans of each polygon crossing the strip in drawing order, and the
+					// painter draws the ones of each polarity together.
+					RowPainter &painter = painters[strip % window];
+					unsigned char *bufferLine = buffer;
+					for (int y = ystart; (y - ystart) < static_cast<int>(rowsPerStrip) && (y <= maxy); y++, bufferLine += bytesPerScanline)
 					{
-						if (y > it->polygon->pixelMaxY)
+						painter.begin(bufferLine, int(imageWidth), !isPolarityDark);
+						strips[strip % window].scanLine(y, [&](int x1, int x2, Polarity_t pol)
 						{
-							it = activePolys.erase(it);
-							continue;
-						}
-						int sliCount;
-						int *sliTable;
-						it->polygon->getNextLineX1X2Pairs(sliTable, sliCount);
+							if ((pol == DARK) && !isPolarityDark)
+								pol = CLEAR;
+							if ((pol == CLEAR) && isPolarityDark)
+								pol = DARK;
+							painter.draw(xOffset + x1, xOffset + x2, pol);
+						});
+						painter.flush();
+					}
 
-						Polarity_t pol = it->polygon->polarity;
-						if ((pol == DARK) && !isPolarityDark)
-							pol = CLEAR;
-						if ((pol == CLEAR) && isPolarityDark)
-							pol = DARK;
+					// Compress the strip on its own, so it can be written as it is
+					if (!jbig)
+						encoders[strip % window].encode(buffer, imageWidth, lines, bytesPerScanline);
+				},
+				[&](size_t strip)
+				{
+					rasterizer.finish(strips[strip % window]);
 
-						for (int i = 0; i < sliCount; i += 2)
-						{
-							horizontalLine(xOffset + it->polygon->pixelOffsetX + sliTable[i],
-										   xOffset + it->polygon->pixelOffsetX + sliTable[i + 1],
-										   bufferLine, pol);
-						}
-						it++;
+					//
+					// Write strip buffer to TIFF
+					//
+					if (jbig)
+					{
+						unsigned lines = std::min(rowsPerStrip, imageHeight - rowsPerStrip * unsigned(strip));
+						jbig->encode(bitmap + strip % window * bitmapBytes, lines, bytesPerScanline);
+						return;
 					}
-				}
+					const std::vector<unsigned char> &data = encoders[strip % window].data();
+					if (TIFFWriteRawStrip(tif, unsigned(strip), (void *)data.data(), tmsize_t(data.size())) < 0)
+						throw std::string("cannot write to output file");
+				});
 
-				//
-				// Write strip buffer to TIFF
-				//
-				unsigned lines = std::min(rowsPerStrip, imageHeight - rowsPerStrip * stripCounter);
-				TIFFWriteEncodedStrip(tif, stripCounter++, bitmap, bytesPerScanline * lines);
+				if (jbig && TIFFWriteRawStrip(tif, 0, jbig->data.data(), tmsize_t(jbig->data.size())) < 0)
+					throw std::string("cannot write to output file");
+			}
+			catch (...)
+			{
+				TIFFClose(tif);
+				std::free(bitmap);
+				throw;
 			}
 			TIFFClose(tif);
 			std::free(bitmap);
@@ -536,6 +477,50 @@ extern "C" __declspec(dllexport) int __stdcall processGerber(
 	}
 }
 
+//**********************************************************
+extern "C" __declspec(dllexport) int __stdcall processGerber(
+	double imageDPI,
+	bool optGrowUnitsMillimeters,
+	bool optBoarderUnitsMillimeters,
+	double optBoarder,
+	bool optInvertPolarity,
+	unsigned rowsPerStrip,
+	double optGrowSize,
+	double optScaleX,
+	double optScaleY,
+	const char *outputFilename,
+	const char *inputFilename)
+{
+	return renderGerber(imageDPI, optGrowUnitsMillimeters, optBoarderUnitsMillimeters, optBoarder, optInvertPolarity,
+						rowsPerStrip, optGrowSize, optScaleX, optScaleY, outputFilename, inputFilename, 0, 0, 1, CODEC_CCITT_RLE);
+}
+
+//**********************************************************
+// Same as processGerber(), but the Gerber file contents are passed in memory
+// (inputData, inputSize bytes) so the caller does not need to write them to disk.
+//**********************************************************
+extern "C" __declspec(dllexport) int __stdcall processGerberData(
+	double imageDPI,
+	bool optGrowUnitsMillimeters,
+	bool optBoarderUnitsMillimeters,
+	double optBoarder,
+	bool optInvertPolarity,
+	unsigned rowsPerStrip,
+	double optGrowSize,
+	double optScaleX,
+	double optScaleY,
+	const char *outputFilename,
+	const char *inputData,
+	size_t inputSize)
+{
+	if (!inputData || inputSize == 0)
+	{
+		return ERROR_INVALID_PARAMETERS; // код ошибки: некорректные параметры
+	}
+	return renderGerber(imageDPI, optGrowUnitsMillimeters, optBoarderUnitsMillimeters, optBoarder, optInvertPolarity,
+						rowsPerStrip, optGrowSize, optScaleX, optScaleY, outputFilename, 0, inputData, inputSize, 1, CODEC_CCITT_RLE);
+}
+
 extern "C" __declspec(dllexport) int __stdcall processGerberJSON(const char *jsonParams)
 {
 	try
@@ -554,9 +539,36 @@ extern "C" __declspec(dllexport) int __stdcall processGerberJSON(const char *jso
 		double optScaleY = j.value("optScaleY", 1.0);
 		std::string outputFilename = j.value("outputFilename", "");
 		std::string inputFilename = j.value("inputFilename", "");
+		std::string inputData = j.value("inputData", ""); // содержимое Gerber-файла вместо имени файла
+		int threads = j.value("threads", 1);			  // потоки для подготовки полигонов, 0 - по числу процессоров
+		Codec_t codec = CODEC_CCITT_RLE;				  // сжатие TIFF, см. codecNames
+		if (threads < 0)
+			return ERROR_INVALID_PARAMETERS; // код ошибки: некорректные параметры
+		if (!findCodec(j.value("compression", "ccitt-rle"), codec))
+			return ERROR_INVALID_PARAMETERS; // код ошибки: некорректные параметры
+
+		if (!inputData.empty())
+		{
+			return renderGerber(
+				imageDPI,
+				optGrowUnitsMillimeters,
+				optBoarderUnitsMillimeters,
+				optBoarder,
+				optInvertPolarity,
+				rowsPerStrip,
+				optGrowSize,
+				optScaleX,
+				optScaleY,
+				outputFilename.c_str(),
+				0,
+				inputData.data(),
+				inputData.size(),
+				threads,
+				codec);
+		}
 
 		// Вызов основного процесса
-		return processGerber(
+		return renderGerber(
 			imageDPI,
 			optGrowUnitsMillimeters,
 			optBoarderUnitsMillimeters,
@@ -567,7 +579,11 @@ extern "C" __declspec(dllexport) int __stdcall processGerberJSON(const char *jso
 			optScaleX,
 			optScaleY,
 			outputFilename.c_str(),
-			inputFilename.c_str());
+			inputFilename.c_str(),
+			0,
+			0,
+			threads,
+			codec);
 	}
 	catch (const std::exception &e)
 	{
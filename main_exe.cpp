@@ -15,11 +15,18 @@
 #include <tiffio.h>
 #include <stdarg.h>
 #include <string.h>
+#include <chrono>
+#include <memory>
 #include "config.h"
 
 #include "polygon.h"
 #include "apertures.h"
+#include "compression.h"
 #include "gerber.h"
+#include "parallel.h"
+#include "rasterizer.h"
+#include "row_runs.h"
+#include "span_fill.h"
 
 unsigned char nbitsTable[256];
 
@@ -37,6 +44,9 @@ const char *help_message =
 	"                       This option is required when no gerber-file specified.\n"
 	"  -v                   Verbose mode, display information while processing\n"
 	"                       multiple -v increases verbosity. Disables --quiet\n"
+	"  --threads=N          Parse up to N input files at the same time, then prepare\n"
+	"                       their polygons and draw the image strips on N threads.\n"
+	"                       0 uses all processors. Default 1\n"
 	"  --help               This help screen\n"
 	"\n"
 	"Image options: \n"
@@ -48,12 +58,15 @@ const char *help_message =
 	"                       Negative values shrink. Fractional pixels allowed.\n"
 	"  --grow-mm=X          Same as --grow-pixels except X is in unit millimeters.\n"
 	"  --strip-rows=N       Specify N rows per strip in TIFF. Default 512\n"
+	"  --compression=NAME   TIFF compression: ccitt-rle, ccitt-g4, packbits, deflate,\n"
+	"                       zstd or jbig. Default ccitt-rle. A jbig TIFF is a single\n"
+	"                       strip, compressed on one thread.\n"
 	"  --scale-y=FACTOR     Scale image in Y axis by FACTOR. Default 1\n"
 	"  --scale-x=FACTOR     Scale image in X axis by FACTOR. Default 1\n"
 	"\n"
 	"Where file1 file2... are gerber files rendered as overlays to a single bitmap.\n"
 	"Standard input is read if no gerber files specified and --output is specified.\n"
-	"Output bitmap is compressed monochrome TIFF"
+	"Output bitmap is compressed monochrome TIFF";
 
 
 void show_interval(const char *msg = "")
@@ -84,6 +97,8 @@ int optVerbose = 0;
 unsigned rowsPerStrip = 512;
 bool optShowArea = false;
 bool optQuiet = false;
+unsigned optThreads = 1;
+Codec_t optCodec = CODEC_CCITT_RLE;
 double total_area_cmsq = 0;
 double optGrowSize = 0;
 double optScaleX = 1;
@@ -92,99 +107,14 @@ unsigned int bytesPerScanline;
 unsigned int bitmapBytes;
 unsigned char *bitmap;
 
-//***********************************************************
-
-//**********************************************************
-// Optimised horizontal line drawing from x1,y to x2,y in the monochrome bitmap
-// polarity specifies how pixels are changed.
-// DRAW_ON = line is drawn bits set
-// DRAW_OFF = line is drawn bits cleared
-// DRAW_REVERSE  = line is drawn bits inverted
-//
-// global dependencies:	bytesPerScanline, bitmap
-//**********************************************************
-void horizontalLine(int x1, int x2, unsigned char *buffer, Polarity_t polarity)
+//---------------------------------------------------------------------------------
+// Prints the name of an input file in the "gerb2img: file1 + file2 ..." progress line.
+void showInputFile(const std::string &name, bool isFirst)
 {
-	if (x1 > x2)
-		std::swap(x1, x2);
-
-	static unsigned char fillSingle[64] = {
-		0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-		0xC0, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-		0xE0, 0x60, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00,
-		0xF0, 0x70, 0x30, 0x10, 0x00, 0x00, 0x00, 0x00,
-		0xF8, 0x78, 0x38, 0x18, 0x08, 0x00, 0x00, 0x00,
-		0xFC, 0x7C, 0x3C, 0x1C, 0x0C, 0x04, 0x00, 0x00,
-		0xFE, 0x7E, 0x3E, 0x1E, 0x0E, 0x06, 0x02, 0x00,
-		0xFF, 0x7F, 0x3F, 0x1F, 0x0F, 0x07, 0x03, 0x01};
-
-	static unsigned char fillLast[8] = {0x80, 0xC0, 0xE0, 0xF0, 0xF8, 0xFC, 0xFE, 0xFF};
-	static unsigned char fillFirst[8] = {0xFF, 0x7F, 0x3F, 0x1F, 0x0F, 0x07, 0x03, 0x01};
-
-	const unsigned char b1 = static_cast<unsigned char>(x1 & 7); // Исправлено: char -> unsigned char
-	const unsigned char b2 = static_cast<unsigned char>(x2 & 7); // Исправлено: char -> unsigned char
-
-	unsigned char *px1 = buffer + (x1 >> 3);
-	unsigned char *px2 = buffer + (x2 >> 3);
-
-	// left pixel = MSB
-	// right pixel = LSB
-	switch (polarity)
-	{
-	case DARK: // plot line with set bits
-		// fill in the pixels at the byte x1, and x2 occupy.
-		if (px1 == px2)
-		{ // x1 and x2 occupy the same  byte
-			*px1 |= fillSingle[b1 + (b2 << 3)];
-		}
-		else
-		{ // x1 and x2 occupy different bytes
-			*px1 |= fillFirst[b1];
-			*px2 |= fillLast[b2];
-			// fill only the whole bytes in buffer between x1 and x2
-			px1++;
-			memset(px1, 0xFF, (px2 - px1));
-		}
-		break;
-
-	case CLEAR: // plot line with cleared bits
-
-		if (px1 == px2) // fill in the pixels at the byte x1, and x2 occupy.
-		{				// x1 and x2 occupy the same  byte
-			*px1 &= ~fillSingle[b1 + (b2 << 3)];
-		}
-		else
-		{ // x1 and x2 occupy different bytes
-			*px1 &= ~fillFirst[b1];
-			*px2 &= ~fillLast[b2];
-			// fill only the whole bytes in buffer between x1 and x2
-			px1++;
-			memset(px1, 0x0, (px2 - px1));
-		}
-		break;
-
-	case XOR: // invert the pixels
-		// fill in the pixels at the byte x1, and x2 occupy.
-		if (px1 == px2)
-		{ // x1 and x2 occupy the same  byte
-			*px1 ^= fillSingle[b1 + (b2 << 3)];
-		}
-		else
-		{ // x1 and x2 occupy different bytes
-			*px1 ^= fillFirst[b1];
-			*px2 ^= fillLast[b2];
-			// XOR only the whole bytes in buffer between x1 and x2 (exclusive)
-			px1++;
-			while (px1 < px2)
-			{
-				*px1 ^= 0xFF;
-				px1++;
-			}
-		}
-		break;
-	}
-
-} // end HorizontalLine()
+	if (optQuiet)
+		return;
+	std::cout << (isFirst ? "gerb2img: " : "+ ") << name << " " << std::flush;
+}
 
 //---------------------------------------------------------------------------------
 int main(int argc, char **argv)
@@ -243,6 +173,8 @@ int main(int argc, char **argv)
 				{"boarder-mm", LOCAL_REQUIRED_ARGUMENT, 0, 'b'},
 				{"boarder-pixels", LOCAL_REQUIRED_ARGUMENT, 0, 7},
 				{"rotation", LOCAL_REQUIRED_ARGUMENT, 0, 8},
+				{"threads", LOCAL_REQUIRED_ARGUMENT, 0, 9},
+				{"compression", LOCAL_REQUIRED_ARGUMENT, 0, 10},
 				{0, 0, 0, 0}};
 		// getopt_long stores the option index here.
 		int option_index = 0;
@@ -256,6 +188,15 @@ int main(int argc, char **argv)
 		switch (c)
 		{
 
+		case 10:
+			if (!findCodec(optarg, optCodec))
+				error(std::string("unknown compression '") + optarg + "', use one of " + codecNames);
+			break;
+		case 9:
+			if (atoi(optarg) < 0)
+				error(std::string("threads setting must be >= 0"));
+			optThreads = atoi(optarg);
+			break;
 		case 8:
 			optRotation = atof(optarg);
 			break;
@@ -338,42 +279,55 @@ int main(int argc, char **argv)
 
 	int first_optind = optind;
 
+	// With several input files and --threads, all files are parsed up front and the loop below only
+	// reports them, in command line order, exactly as a serial run would.
+	std::vector<Gerber *> preparsed;
+	if (!isStandardInput && optThreads != 1 && argc - optind > 1)
+	{
+		preparsed.resize(argc - optind, 0);
+		unsigned threadsPerFile = std::max(1u, threadCount(optThreads) / unsigned(preparsed.size())); // share the threads left over
+		parallelFor(preparsed.size(), optThreads, [&](size_t i)
+		{
+			MappedFile file(argv[first_optind + i]);
+			if (file.isOpen())
+				preparsed[i] = new Gerber(file, imageDPI, optGrowSize, optScaleX, optScaleY, threadsPerFile);
+		});
+	}
+
 	for (; optind < argc || isStandardInput; optind++)
 	{
-		FILE *file = 0;
 		if (isStandardInput)
 		{
-			file = stdin;
 			if (!optTestOnly && outputFilename.empty())
 			{
 				std::cerr << "no output or input file specified.\n"
 						  << "Try 'gerb2img --help' for more information.\n";
 				return 1;
 			}
+			gerbers.push_back(new Gerber(stdin, imageDPI, optGrowSize, optScaleX, optScaleY, optThreads));
 		}
 		else
 		{
 			inputfile = argv[optind];
 			if (outputFilename.empty())
 				outputFilename = inputfile + ".tiff";
-			file = fopen(argv[optind], "rb");
-			if (file == NULL)
-				error(std::string("cannot open input file ") + inputfile);
-			if (!optQuiet)
+			if (preparsed.empty())
+			{
+				MappedFile file(argv[optind]); // parsed in place, unmapped at end of this block
+				if (!file.isOpen())
+					error(std::string("cannot open input file ") + inputfile);
+				showInputFile(inputfile, optind == first_optind);
+				gerbers.push_back(new Gerber(file, imageDPI, optGrowSize, optScaleX, optScaleY, optThreads));
+			}
+			else
 			{
-				if (optind == first_optind)
-					std::cout << "gerb2img: ";
-				if (!optQuiet && optind > first_optind)
-					std::cout << "+ ";
-				std::cout << inputfile << " " << std::flush;
+				if (preparsed[optind - first_optind] == 0)
+					error(std::string("cannot open input file ") + inputfile);
+				showInputFile(inputfile, optind == first_optind);
+				gerbers.push_back(preparsed[optind - first_optind]);
 			}
 		}
 
-		gerbers.push_back(new Gerber(file, imageDPI, optGrowSize, optScaleX, optScaleY));
-
-		if (!isStandardInput)
-			fclose(file);
-
 		// print all warning messages
 		for (size_t i = 0; i < gerbers.back()->messages.size() && !optQuiet; i++)
 		{
@@ -396,55 +350,21 @@ int main(int argc, char **argv)
 	if (!optQuiet)
 		std::cout << std::endl;
 
-	int miny = INT_MAX; // holds min and max dimentions of the occupied gerber images (superimposed)
-	int minx = INT_MAX;
-	int maxy = INT_MIN;
-	int maxx = INT_MIN;
-	std::list<Polygon> globalPolygons; // Contains polygons created by the all gerbers.
-
 	// group all the polygons
+	Rasterizer rasterizer(optThreads);
 	for (std::list<Gerber *>::iterator it = gerbers.begin(); it != gerbers.end(); it++)
 	{
-		globalPolygons.merge((*it)->polygons);
+		rasterizer.add(**it);
 	}
 
-	//    for (int i=0; i < 100; i++)
-	//    {
-	//    	double radius = 50.0 * rand() / double(RAND_MAX);
-	//    	double x0  = 2000.0 * rand() / double(RAND_MAX);
-	//    	double y0  = 2000.0 * rand() / double(RAND_MAX);
-	//        globalPolygons.push_back(Polygon() );
-	//        globalPolygons.back().number = 1;
-	//        globalPolygons.back().vdata->add( 0,0);
-	//        globalPolygons.back().vdata->add(100,0);
-	//        globalPolygons.back().vdata->add(100,50);
-	//        globalPolygons.back().vdata->add( 0,50);
-	//        globalPolygons.back().vdata->rotate(222 *M_PI/180);
-	//        globalPolygons.back().vdata->initialise();
-	//        globalPolygons.back().initialise();
-	//    }
-
-	//    globalPolygons.sort();
-	//        globalPolygons.push_back(Polygon() );
-	//        globalPolygons.back().addArc(0, 2*M_PI, 10, 0, 0, false );
-	//        globalPolygons.back().number = 0;
-	//        globalPolygons.back().initialise();
-
-	if (globalPolygons.size() == 0) // If nothing to draw then abort with error
+	if (rasterizer.empty()) // If nothing to draw then abort with error
 		error("no image");
 
-	// find extreme (x,y) coordinates for all polygons
-	for (std::list<Polygon>::iterator it = globalPolygons.begin(); it != globalPolygons.end(); it++)
-	{
-		if (minx > it->pixelMinX)
-			minx = it->pixelMinX;
-		if (maxx < it->pixelMaxX)
-			maxx = it->pixelMaxX;
-		if (miny > it->pixelMinY)
-			miny = it->pixelMinY;
-		if (maxy < it->pixelMaxY)
-			maxy = it->pixelMaxY;
-	}
+	// holds min and max dimentions of the occupied gerber images (superimposed)
+	int miny = rasterizer.miny;
+	int minx = rasterizer.minx;
+	int maxy = rasterizer.maxy;
+	int maxx = rasterizer.maxx;
 
 	// use the world coordinate limits <maxx, minx, maxx, minx> to determine the
 	// sized  of the bitmap buffer to allocate for drawing the image
@@ -458,14 +378,15 @@ int main(int argc, char **argv)
 	isPolarityDark = (optInvertPolarity ^ gerbers.front()->imagePolarityDark); // polarity is relative to 1st gerber file
 	if (rowsPerStrip > unsigned(imageHeight) || rowsPerStrip == 0)
 		rowsPerStrip = imageHeight;
-	unsigned darkPixelsCount = 0;
+	uint64_t darkPixelsCount = 0;
 
 	//
 	// Eye candy
 	//
 	if (optVerbose >= 2)
 	{
-		std::printf("polygon count:               %llu\n", static_cast<unsigned long long>(globalPolygons.size())); // Исправлено: %d -> %llu
+		std::printf("polygon count:               %llu\n", static_cast<unsigned long long>(rasterizer.polygonCount)); // Исправлено: %d -> %llu
+		std::printf("drawing order:               %s\n", rasterizer.isOrdered ? "kept, mixed polarities" : "not needed, single polarity");
 		std::printf("grow option:                 %.1f pixels , %.3f mm\n", optGrowSize, optGrowSize / imageDPI * 25.4);
 	}
 	if (optVerbose >= 1)
@@ -500,125 +421,238 @@ int main(int argc, char **argv)
 
 	TIFFSetField(tif, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);	// avoid errors, dispite TIFF spec saying this tag not needed in monochrome images.
 	TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_MINISWHITE); // white pixels are zero
-	TIFFSetField(tif, TIFFTAG_COMPRESSION, COMPRESSION_CCITTRLE);	// use CCITT Group 3 1-Dimensional Modified Huffman run length encoding
+	TIFFSetField(tif, TIFFTAG_COMPRESSION, tiffCompression(optCodec)); // CCITT Group 3 1-Dimensional Modified Huffman run length encoding by default
 	TIFFSetField(tif, TIFFTAG_IMAGELENGTH, imageHeight);
 	TIFFSetField(tif, TIFFTAG_IMAGEWIDTH, imageWidth);
 	TIFFSetField(tif, TIFFTAG_RESOLUTIONUNIT, 2); // Resulution unit in inches
 	TIFFSetField(tif, TIFFTAG_YRESOLUTION, imageDPI);
 	TIFFSetField(tif, TIFFTAG_XRESOLUTION, imageDPI);
-	TIFFSetField(tif, TIFFTAG_ROWSPERSTRIP, rowsPerStrip);
+	TIFFSetField(tif, TIFFTAG_ROWSPERSTRIP, optCodec == CODEC_JBIG ? imageHeight : rowsPerStrip); // libtiff reads JBIG as one strip only
 
 	//
-	// Calculate size and allocate buffer for drawing. The image will be rendered sequential blocks of
-	// imageWidth wide by rowsPerStrip high.
+	// Calculate size and allocate buffers for drawing. The image will be rendered in blocks of
+	// imageWidth wide by rowsPerStrip high, several at a time with --threads. Each block has its own
+	// bitmap and compressed data buffer, reused by every window'th strip. CCITT strips are encoded
+	// straight from the spans of each row instead, and need no bitmap.
 	//
+	unsigned stripCount = (imageHeight + rowsPerStrip - 1) / rowsPerStrip;
+	size_t window = threadCount(optThreads) > 1 ? std::min<size_t>(stripCount, 2 * threadCount(optThreads)) : 1; // strips in flight
+	std::vector<Rasterizer::Strip> strips(window);
+	std::vector<StripEncoder> encoders(window, StripEncoder(optCodec));
+	bool isDrawnByRows = encoders[0].encodesRows();
 	bytesPerScanline = ((imageWidth + 7) >> 3);
-	bitmapBytes = bytesPerScanline * rowsPerStrip;
-	bitmap = (unsigned char *)malloc(bitmapBytes);
-	if (bitmap == 0)
+	bitmapBytes = isDrawnByRows ? 0 : bytesPerScanline * rowsPerStrip;
+	bitmap = 0;
+	if (!isDrawnByRows && (bitmap = (unsigned char *)malloc(window * bitmapBytes)) == 0)
 		error("cannot allocate memory");
+	std::vector<RowRuns> rows(isDrawnByRows ? window : 0);
+	std::vector<RowPainter> painters(isDrawnByRows ? 0 : window);
+	std::vector<unsigned> darkPixels(window);	// of a strip drawn by rows
+	std::unique_ptr<JbigEncoder> jbig(optCodec == CODEC_JBIG ? new JbigEncoder(imageWidth, imageHeight) : 0);
+	size_t outputBytes = 0;
+
+	// seconds spent in each stage of the strip pipeline, the draw and compress times of a strip kept by its
+	// buffer until added up in order
+	typedef std::chrono::steady_clock Clock;
+	std::vector<double> drawTimes(window), compressTimes(window);
+	double prepareSeconds = 0, drawSeconds = 0, compressSeconds = 0, writeSeconds = 0;
+	Clock::time_point pipelineStart = Clock::now();
 
 	//-----------------------------------------------------------------------
 	// Draw polygons
 	//-----------------------------------------------------------------------
 	xOffset -= minx;
 
-	int stripCounter = 0;
-	std::list<Polygon>::iterator polyIterator = globalPolygons.begin();
-	std::list<PolygonReference> activePolys;
-
-	// The bitmap will be divided into strips, of height rowsPerStrip.
-	// Polygons are plotted for each strip consecutively in a loop, where the strip y coordinate equals ystart
-	for (unsigned int ystart = static_cast<unsigned int>(miny - yOffset); ystart < (static_cast<unsigned int>(imageHeight) + static_cast<unsigned int>(miny - yOffset)); ystart += rowsPerStrip) // Исправлено: int -> unsigned int
+	// The bitmap is divided into strips of height rowsPerStrip, where the strip y coordinate equals ystart.
+	// The strips are set up in order, drawn and compressed by the worker threads each in their own buffer,
+	// and written to the TIFF in order. A JBIG image is compressed while writing instead, as a single stream.
+	// The scan line data of the polygons is created on the way, which can fail.
+	try
 	{
-		// blank entire strip buffer, set pixels on/off depending on polarity of the 1st Gerber.
-		if (isPolarityDark)
-			memset(bitmap, 0x00, bitmapBytes);
-		else
-			memset(bitmap, 0xff, bitmapBytes);
-
-		unsigned char *bufferLine = bitmap;
-
-		// Loop over each row of the strip and fill with horizontal lines from the polygon raster data.
-		// All polygon are sorted in the list globalPolygons. Iterating each polygon for raster data will guarantee no missing lines.
-		for (unsigned int y = ystart; (y - ystart) < rowsPerStrip && (y <= static_cast<unsigned int>(maxy)); y++, bufferLine += bytesPerScanline) // Исправлено: maxy -> unsigned int
+		parallelPipeline(stripCount, optThreads, window, [&](size_t strip)
 		{
-			while (polyIterator != globalPolygons.end() && y == static_cast<unsigned int>(polyIterator->pixelMinY)) // Исправлено: pixelMinY -> unsigned int
-			{
-				activePolys.push_back(PolygonReference());
-				activePolys.back().polygon = &(*polyIterator);
-				activePolys.sort();
-				//				printf("added poly %d (y=%d)\n", activePolys.back().polygon->number, y);
-				polyIterator++;
-			}
-
-			for (std::list<PolygonReference>::iterator it = activePolys.begin(); it != activePolys.end();)
+			Clock::time_point begin = Clock::now();
+			int ystart = miny - yOffset + int(strip * rowsPerStrip);
+			rasterizer.prepare(ystart, std::min(ystart + int(rowsPerStrip) - 1, maxy), strips[strip % window]);
+			prepareSeconds += std::chrono::duration<double>(Clock::now() - begin).count();
+		},
+		[&](size_t strip)
+		{
+			Clock::time_point begin = Clock::now();
+			int ystart = miny - yOffset + int(strip * rowsPerStrip);
+			unsigned lines = std::min(rowsPerStrip, imageHeight - rowsPerStrip * unsigned(strip));
+			if (isDrawnByRows)
 			{
-				if (y > static_cast<unsigned int>(it->polygon->pixelMaxY)) // Исправлено: pixelMaxY -> unsigned int
+				// Draw each row of the strip as its changing pixels and encode it right away, all rows starting
+				// in the colour of the 1st Gerber's polarity.
+				RowRuns &row = rows[strip % window];
+				StripEncoder &encoder = encoders[strip % window];
+				double drawn = 0, compressed = 0;
+				darkPixels[strip % window] = 0;
+				encoder.beginStrip();
+				for (unsigned i = 0; i < lines; i++)
 				{
-					//					printf("erased poly %d (y=%d)\n", activePolys.back().polygon->number, y);
-					it = activePolys.erase(it);
-					continue;
+					int y = ystart + int(i);
+					row.reset(int(imageWidth), !isPolarityDark);
+					if (y <= maxy)
+					{
+						strips[strip % window].scanLine(y, [&](int x1, int x2, Polarity_t pol)
+						{
+							if ((pol == DARK) && !isPolarityDark)
+								pol = CLEAR;
+							if ((pol == CLEAR) && isPolarityDark)
+								pol = DARK;
+							row.draw(xOffset + x1, xOffset + x2, pol);
+						});
+					}
+					size_t count = row.size();
+					Clock::time_point rowDrawn = Clock::now();
+					drawn += std::chrono::duration<double>(rowDrawn - begin).count();
+					encoder.encodeRow(row.data(), count, imageWidth);
+					if (optShowArea)
+						darkPixels[strip % window] += row.blackPixels();
+					begin = Clock::now();
+					compressed += std::chrono::duration<double>(begin - rowDrawn).count();
 				}
-				int sliCount;
-				int *sliTable;
-				it->polygon->getNextLineX1X2Pairs(sliTable, sliCount);
+				encoder.endStrip();
+				drawTimes[strip % window] = drawn;
+				compressTimes[strip % window] = compressed + std::chrono::duration<double>(Clock::now() - begin).count();
+				return;
+			}
 
-				//				printf("p %2d y:%d (x cnt %d) |",it->polygon->number, y, sliCount); fflush(stdout);
+			unsigned char *buffer = bitmap + strip % window * bitmapBytes;
 
-				Polarity_t pol = it->polygon->polarity;
-				if ((pol == DARK) && !isPolarityDark)
-					pol = CLEAR;
-				if ((pol == CLEAR) && isPolarityDark)
-					pol = DARK;
+			// blank entire strip buffer, set pixels on/off depending on polarity of the 1st Gerber.
+			if (isPolarityDark)
+				memset(buffer, 0x00, bitmapBytes);
+			else
+				memset(buffer, 0xff, bitmapBytes);
 
-				for (int i = 0; i < sliCount; i += 2)
+			// Loop over each row of the strip and fill with horizontal lines from the polygon raster data.
+			// The rasterizer returns the spans of each polygon crossing the strip in drawing order, and the
+			// painter draws the ones of each polarity together.
+			RowPainter &painter = painters[strip % window];
+			unsigned char *bufferLine = buffer;
+			for (int y = ystart; (y - ystart) < int(rowsPerStrip) && (y <= maxy); y++, bufferLine += bytesPerScanline)
+			{
+				painter.begin(bufferLine, int(imageWidth), !isPolarityDark);
+				strips[strip % window].scanLine(y, [&](int x1, int x2, Polarity_t pol)
 				{
-					//					printf(" %d~%d ",sliTable[i], sliTable[i+1] ); fflush(stdout);
-					horizontalLine(xOffset + it->polygon->pixelOffsetX + sliTable[i],
-								   xOffset + it->polygon->pixelOffsetX + sliTable[i + 1],
-								   bufferLine, pol);
-				}
-				//				printf("\n");
-				it++;
+					if ((pol == DARK) && !isPolarityDark)
+						pol = CLEAR;
+					if ((pol == CLEAR) && isPolarityDark)
+						pol = DARK;
+					painter.draw(xOffset + x1, xOffset + x2, pol);
+				});
+				painter.flush();
 			}
-		}
-
-		//
-		// Write strip buffer to TIFF
-		//
-		unsigned lines = std::min(rowsPerStrip, imageHeight - rowsPerStrip * stripCounter);
-		int percentComplete = (100 * (stripCounter * rowsPerStrip + lines)) / imageHeight;
-		if (optVerbose)
+			Clock::time_point drawn = Clock::now();
+			drawTimes[strip % window] = std::chrono::duration<double>(drawn - begin).count();
+
+			// Compress the strip on its own, so it can be written as it is
+			if (!jbig)
+				encoders[strip % window].encode(buffer, imageWidth, lines, bytesPerScanline);
+			compressTimes[strip % window] = std::chrono::duration<double>(Clock::now() - drawn).count();
+		},
+		[&](size_t strip)
 		{
-			static int last = percentComplete;
-			if (percentComplete != last)
-				std::cout << "Rendering " << percentComplete << "%  \r" << std::flush;
-			last = percentComplete;
-		}
-		TIFFWriteEncodedStrip(tif, stripCounter++, bitmap, bytesPerScanline * lines);
+			Clock::time_point begin = Clock::now();
+			unsigned char *buffer = bitmap + strip % window * bitmapBytes;
+			rasterizer.finish(strips[strip % window]);
+			drawSeconds += drawTimes[strip % window];
+			compressSeconds += compressTimes[strip % window];
+
+			//
+			// Write strip buffer to TIFF
+			//
+			unsigned lines = std::min(rowsPerStrip, imageHeight - rowsPerStrip * unsigned(strip));
+			int percentComplete = (100 * (unsigned(strip) * rowsPerStrip + lines)) / imageHeight;
+			if (optVerbose)
+			{
+				static int last = percentComplete;
+				if (percentComplete != last)
+					std::cout << "Rendering " << percentComplete << "%  \r" << std::flush;
+				last = percentComplete;
+			}
+			double compressed = 0;
+			if (jbig)
+			{
+				Clock::time_point compressing = Clock::now();
+				jbig->encode(buffer, lines, bytesPerScanline);
+				compressed = std::chrono::duration<double>(Clock::now() - compressing).count();
+				compressSeconds += compressed;
+			}
+			else
+			{
+				const std::vector<unsigned char> &data = encoders[strip % window].data();
+				if (TIFFWriteRawStrip(tif, unsigned(strip), (void *)data.data(), tmsize_t(data.size())) < 0)
+					throw std::string("cannot write to output file");
+				outputBytes += data.size();
+			}
 
-		// Calculate positive area information
-		if (optShowArea)
-		{
-			for (unsigned int i = 0; i < lines; i++)
+			// Calculate positive area information, leaving out the padding bits at the end of the rows
+			if (optShowArea && isDrawnByRows)
+				darkPixelsCount += darkPixels[strip % window];
+			else if (optShowArea)
 			{
-				unsigned char *pbitmaprow = bitmap + bytesPerScanline * i;
-				for (unsigned int x = 0; x < bytesPerScanline; x++)
-					darkPixelsCount += nbitsTable[*pbitmaprow];
-				pbitmaprow++;
+				unsigned char lastMask = (unsigned char)(0xff00 >> (imageWidth - 8 * (bytesPerScanline - 1)));
+				for (unsigned int i = 0; i < lines; i++)
+				{
+					unsigned char *pbitmaprow = buffer + bytesPerScanline * i;
+					for (unsigned int x = 0; x + 1 < bytesPerScanline; x++)
+						darkPixelsCount += nbitsTable[*pbitmaprow++];
+					darkPixelsCount += nbitsTable[*pbitmaprow & lastMask];
+				}
 			}
+			writeSeconds += std::chrono::duration<double>(Clock::now() - begin).count() - compressed;
+		});
+
+		if (jbig)
+		{
+			if (TIFFWriteRawStrip(tif, 0, jbig->data.data(), tmsize_t(jbig->data.size())) < 0)
+				throw std::string("cannot write to output file");
+			outputBytes = jbig->data.size();
 		}
 	}
+	catch (const std::string &msg)
+	{
+		TIFFClose(tif);
+		error(msg);
+	}
 	TIFFClose(tif);
+	double pipelineSeconds = std::chrono::duration<double>(Clock::now() - pipelineStart).count();
 
 	if (optVerbose)
 		std::cout << "\n";
 
+	if (optVerbose >= 2)
+	{
+		std::printf("scan line data (MB):         %.1f created, %.1f peak, %.1f saved by compact encoding\n",
+					rasterizer.createdScanLinesBytes / 1048576.0, rasterizer.peakScanLinesBytes / 1048576.0,
+					(rasterizer.plainScanLinesBytes - rasterizer.createdScanLinesBytes) / 1048576.0);
+
+		// Busy time of each stage as a share of the time its threads had, the busiest one being the bottleneck.
+		// Strips are prepared and written on the main thread, drawn and compressed on the worker threads, but
+		// for JBIG, which is compressed on the main thread.
+		unsigned workers = window > 1 ? std::min(threadCount(optThreads), stripCount) : 1;
+		double mainSeconds = std::max(pipelineSeconds, 1e-9), workerSeconds = mainSeconds * workers;
+		std::printf("compressed size (MB):        %.2f\n", outputBytes / 1048576.0);
+		std::printf("strip pipeline (sec):        %.2f for %u strips, %u worker threads\n"
+					"  prepare:                   %.2f (%.0f%% busy)\n"
+					"  draw:                      %.2f (%.0f%% busy)\n"
+					"  compress:                  %.2f (%.0f%% busy)\n"
+					"  write:                     %.2f (%.0f%% busy)\n",
+					pipelineSeconds, stripCount, workers,
+					prepareSeconds, 100 * prepareSeconds / mainSeconds,
+					drawSeconds, 100 * drawSeconds / workerSeconds,
+					compressSeconds, 100 * compressSeconds / (jbig ? mainSeconds : workerSeconds),
+					writeSeconds, 100 * writeSeconds / mainSeconds);
+	}
+
 	if (optShowArea)
 	{
 		std::printf("  dark  area (sq.cm):        %0.1f\n", darkPixelsCount * 2.54 * 2.54 / (imageDPI * imageDPI));
-		std::printf("  clear area (sq.cm):        %0.1f\n", ((imageHeight * imageWidth) - darkPixelsCount * 2.54 * 2.54) / (imageDPI * imageDPI));
+		std::printf("  clear area (sq.cm):        %0.1f\n", (double(imageHeight) * imageWidth - darkPixelsCount) * 2.54 * 2.54 / (imageDPI * imageDPI));
 	}
 
 	if (optVerbose)
@@ -0,0 +1,181 @@
+// This file is distributed under the terms of the GNU General Public License v3.
+
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "mapped_file.h"
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const char *fileName)
+	: buffer(0), length(0), mappedLength(0)
+{
+	HANDLE h = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (h == INVALID_HANDLE_VALUE)
+	{
+		errorText = "cannot open file";
+		return;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(h, &fileSize))
+	{
+		errorText = "cannot get file size";
+		CloseHandle(h);
+		return;
+	}
+	length = size_t(fileSize.QuadPart);
+
+	// The view can only be used in place when the last page has room for the two terminating '\0' characters.
+	// Bytes past the end of file inside the last page are always zero filled by the system.
+	SYSTEM_INFO si;
+	GetSystemInfo(&si);
+	size_t tail = length % si.dwPageSize;
+	if (length > 0 && tail != 0 && si.dwPageSize - tail >= 2)
+	{
+		HANDLE mapping = CreateFileMappingA(h, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+		if (mapping)
+		{
+			buffer = (char *)MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+			CloseHandle(mapping); // the view keeps the mapping alive
+		}
+		if (buffer)
+			mappedLength = length;
+	}
+	if (buffer == 0)
+		readIntoHeap(h);
+	CloseHandle(h);
+}
+
+MappedFile::~MappedFile()
+{
+	if (buffer && mappedLength)
+		UnmapViewOfFile(buffer);
+	else
+		free(buffer);
+}
+
+//
+// Fallback when the file cannot be mapped: read it into a heap buffer with room for the two '\0' characters.
+//
+bool MappedFile::readIntoHeap(void *handle)
+{
+	char *p = (char *)malloc(length + 2);
+	if (p == 0)
+	{
+		errorText = "cannot allocate memory";
+		return false;
+	}
+	size_t done = 0;
+	while (done < length)
+	{
+		DWORD chunk = DWORD(std::min<size_t>(length - done, 0x40000000));
+		DWORD got = 0;
+		if (!ReadFile((HANDLE)handle, p + done, chunk, &got, NULL) || got == 0)
+		{
+			free(p);
+			errorText = "cannot read file";
+			return false;
+		}
+		done += got;
+	}
+	p[length] = p[length + 1] = 0;
+	buffer = p;
+	return true;
+}
+
+#else // POSIX
+
+MappedFile::MappedFile(const char *fileName)
+	: buffer(0), length(0), mappedLength(0)
+{
+	int fd = open(fileName, O_RDONLY);
+	if (fd < 0)
+	{
+		errorText = "cannot open file";
+		return;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0)
+	{
+		errorText = "cannot get file size";
+		close(fd);
+		return;
+	}
+	length = size_t(st.st_size);
+
+	// Reserve zeroed anonymous pages large enough for the file plus the two terminating '\0' characters,
+	// then map the file over the start of them. Everything past the end of file reads as zero.
+	if (length > 0)
+	{
+		size_t page = size_t(sysconf(_SC_PAGESIZE));
+		size_t total = ((length + 2 + page - 1) / page) * page;
+		void *base = mmap(0, total, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (base != MAP_FAILED)
+		{
+			if (mmap(base, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0) != MAP_FAILED)
+			{
+				madvise(base, length, MADV_SEQUENTIAL);
+				buffer = (char *)base;
+				mappedLength = total;
+			}
+			else
+				munmap(base, total);
+		}
+	}
+	if (buffer == 0)
+		readIntoHeap(&fd);
+	close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+	if (buffer && mappedLength)
+		munmap(buffer, mappedLength);
+	else
+		free(buffer);
+}
+
+//
+// Fallback when the file cannot be mapped: read it into a heap buffer with room for the two '\0' characters.
+//
+bool MappedFile::readIntoHeap(void *handle)
+{
+	int fd = *(int *)handle;
+	char *p = (char *)malloc(length + 2);
+	if (p == 0)
+	{
+		errorText = "cannot allocate memory";
+		return false;
+	}
+	size_t done = 0;
+	while (done < length)
+	{
+		ssize_t got = pread(fd, p + done, length - done, off_t(done));
+		if (got <= 0)
+		{
+			free(p);
+			errorText = "cannot read file";
+			return false;
+		}
+		done += size_t(got);
+	}
+	p[length] = p[length + 1] = 0;
+	buffer = p;
+	return true;
+}
+
+#endif
@@ -0,0 +1,39 @@
+// This file is distributed under the terms of the GNU General Public License v3.
+
+#ifndef MAPPED_FILE_H_
+#define MAPPED_FILE_H_
+
+#include <stddef.h>
+#include <string>
+
+/*
+ * MappedFile maps a whole Gerber file into memory so the flex scanner can read it in place.
+ *
+ * The mapping is private (copy-on-write): flex writes a '\0' after every token, and those writes never reach the file.
+ * Two zero bytes are always present after the last byte of the file, as required by yy_scan_buffer().
+ * When the file cannot be mapped that way, it is read into a heap buffer instead.
+ */
+class MappedFile
+{
+private:
+	char *buffer;			// start of the file contents, followed by two '\0' characters
+	size_t length;			// size of the file in bytes, not including the two '\0' characters
+	size_t mappedLength;	// number of bytes mapped, 0 when buffer is heap allocated
+	std::string errorText;
+
+	MappedFile(const MappedFile &);				// not copyable
+	MappedFile &operator=(const MappedFile &);
+
+	bool readIntoHeap(void *handle);
+
+public:
+	MappedFile(const char *fileName);
+	~MappedFile();
+
+	bool isOpen() const 		{ return buffer != 0; }
+	char *data() const 			{ return buffer; }
+	size_t size() const 		{ return length; }
+	const std::string &error() const { return errorText; }
+};
+
+#endif // MAPPED_FILE_H_
@@ -0,0 +1,257 @@
+// This file is distributed under the terms of the GNU General Public License v3.
+
+#ifndef PARALLEL_H_
+#define PARALLEL_H_
+
+#include <stddef.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//
+// Number of threads to use for a requested count, where 0 means one per hardware thread.
+//
+inline unsigned threadCount(unsigned requested)
+{
+	if (requested == 0)
+		requested = std::thread::hardware_concurrency();
+	return requested ? requested : 1;
+}
+
+//
+// Calls task(i) for every i in [0, count) on up to 'threads' threads, the calling thread being one of them.
+// Indices are handed out in increasing order. Once every task has finished, the exception thrown by the
+// task with the lowest index, if any, is rethrown in the calling thread.
+//
+template <class Task>
+void parallelFor(size_t count, unsigned threads, Task task)
+{
+	threads = threadCount(threads);
+	if (threads > count)
+		threads = unsigned(count);
+	if (threads <= 1)
+	{
+		for (size_t i = 0; i < count; i++)
+			task(i);
+		return;
+	}
+
+	std::atomic<size_t> next(0);
+	std::vector<std::exception_ptr> failures(count);
+	auto worker = [&]()
+	{
+		for (size_t i; (i = next.fetch_add(1)) < count;)
+		{
+			try
+			{
+				task(i);
+			}
+			catch (...)
+			{
+				failures[i] = std::current_exception();
+			}
+		}
+	};
+
+	std::vector<std::thread> pool;
+	for (unsigned t = 1; t < threads; t++)
+		pool.emplace_back(worker);
+	worker();
+	for (size_t t = 0; t < pool.size(); t++)
+		pool[t].join();
+
+	for (size_t i = 0; i < count; i++)
+		if (failures[i])
+			std::rethrow_exception(failures[i]);
+}
+
+//
+// Calls task(begin, end) for consecutive ranges of at most 'chunk' indices covering [0, count), spread over
+// up to 'threads' threads as parallelFor() does.
+//
+template <class Task>
+void parallelForChunks(size_t count, size_t chunk, unsigned threads, Task task)
+{
+	parallelFor((count + chunk - 1) / chunk, threads, [&](size_t i)
+	{
+		task(i * chunk, std::min(count, (i + 1) * chunk));
+	});
+}
+
+//
+// Stable sort by an integer key: fills order with the indices [0, count) by increasing key(i), equal keys by
+// increasing index. This is a radix sort, one counting pass for keys spanning up to 65536 values such as the scan
+// lines of an image, and one more for each further 16 bits. The indices are split into a part per thread: each
+// thread counts the digits of its part, then places its part after those of the parts before it.
+//
+template <class Key>
+void parallelSortByKey(size_t count, unsigned threads, Key key, std::vector<size_t> &order)
+{
+	order.resize(count);
+	if (count == 0)
+		return;
+	size_t parts = std::min<size_t>(threadCount(threads), count / 4096 + 1); // not worth it for small ranges
+	std::vector<size_t> bounds(parts + 1);
+	for (size_t p = 0; p <= parts; p++)
+		bounds[p] = count * p / parts;
+
+	std::vector<int> keys(count);
+	std::vector<int> minKeys(parts), maxKeys(parts);
+	parallelFor(parts, threads, [&](size_t p)
+	{
+		int low = key(bounds[p]), high = low;
+		for (size_t i = bounds[p]; i < bounds[p + 1]; i++)
+		{
+			keys[i] = key(i);
+			low = std::min(low, keys[i]);
+			high = std::max(high, keys[i]);
+			order[i] = i;
+		}
+		minKeys[p] = low;
+		maxKeys[p] = high;
+	});
+	int minKey = *std::min_element(minKeys.begin(), minKeys.end());
+	unsigned range = unsigned(*std::max_element(maxKeys.begin(), maxKeys.end())) - unsigned(minKey);
+	int bits = 0;
+	while (bits < 32 && (range >> bits) != 0)
+		bits++;
+	int passes = (bits + 15) / 16;
+	int digitBits = passes ? (bits + passes - 1) / passes : 0;
+	size_t digits = size_t(1) << digitBits;
+
+	std::vector<size_t> sorted(count), places(parts * digits);
+	for (int pass = 0; pass < passes; pass++)
+	{
+		int shift = pass * digitBits;
+		parallelFor(parts, threads, [&](size_t p)
+		{
+			size_t *counts = &places[p * digits];
+			std::fill(counts, counts + digits, 0);
+			for (size_t i = bounds[p]; i < bounds[p + 1]; i++)
+				counts[((unsigned(keys[order[i]]) - unsigned(minKey)) >> shift) & (digits - 1)]++;
+		});
+		size_t place = 0;
+		for (size_t d = 0; d < digits; d++)
+			for (size_t p = 0; p < parts; p++)
+			{
+				size_t n = places[p * digits + d];
+				places[p * digits + d] = place;
+				place += n;
+			}
+		parallelFor(parts, threads, [&](size_t p)
+		{
+			size_t *next = &places[p * digits];
+			for (size_t i = bounds[p]; i < bounds[p + 1]; i++)
+				sorted[next[((unsigned(keys[order[i]]) - unsigned(minKey)) >> shift) & (digits - 1)]++] = order[i];
+		});
+		order.swap(sorted);
+	}
+}
+
+//
+// Runs the items [0, count) through three stages: prepare(i) and finish(i) on the calling thread in increasing
+// order, and work(i) in between on up to 'threads' other threads. At most 'window' items are between prepare()
+// and finish() at any time, so item i can use slot i % window of buffers held by the caller. An exception thrown
+// by work(i) is rethrown in the calling thread in place of finish(i).
+//
+template <class Prepare, class Work, class Finish>
+void parallelPipeline(size_t count, unsigned threads, size_t window, Prepare prepare, Work work, Finish finish)
+{
+	threads = threadCount(threads);
+	if (threads <= 1 || window <= 1 || count <= 1)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			prepare(i);
+			work(i);
+			finish(i);
+		}
+		return;
+	}
+
+	std::mutex mutex;
+	std::condition_variable isReady;		// an item was prepared, or the pipeline stopped
+	std::condition_variable isWorked;		// an item was worked
+	size_t prepared = 0, next = 0;			// items prepared, next item to work
+	bool isStopped = false;
+	std::vector<char> isDone(window);
+	std::vector<std::exception_ptr> failures(window);
+
+	auto worker = [&]()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		for (;;)
+		{
+			isReady.wait(lock, [&]() { return next < prepared || isStopped; });
+			if (isStopped)
+				return;
+			size_t i = next++;
+			lock.unlock();
+			std::exception_ptr failure;
+			try
+			{
+				work(i);
+			}
+			catch (...)
+			{
+				failure = std::current_exception();
+			}
+			lock.lock();
+			failures[i % window] = failure;
+			isDone[i % window] = 1;
+			isWorked.notify_all();
+		}
+	};
+
+	// stops and joins the workers however this function is left
+	struct Pool
+	{
+		std::vector<std::thread> threads;
+		std::mutex &mutex;
+		std::condition_variable &isReady;
+		bool &isStopped;
+		~Pool()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				isStopped = true;
+			}
+			isReady.notify_all();
+			for (size_t t = 0; t < threads.size(); t++)
+				threads[t].join();
+		}
+	} pool = { std::vector<std::thread>(), mutex, isReady, isStopped };
+	if (threads > count)
+		threads = unsigned(count);
+	for (unsigned t = 0; t < threads; t++)
+		pool.threads.emplace_back(worker);
+
+	for (size_t i = 0, finished = 0; finished < count;)
+	{
+		if (i < count && i - finished < window)
+		{
+			prepare(i++);
+			std::lock_guard<std::mutex> lock(mutex);
+			prepared = i;
+			isReady.notify_one();
+			continue;
+		}
+
+		std::exception_ptr failure;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			isWorked.wait(lock, [&]() { return isDone[finished % window] != 0; });
+			isDone[finished % window] = 0;
+			failure = failures[finished % window];
+		}
+		if (failure)
+			std::rethrow_exception(failure);
+		finish(finished++);
+	}
+}
+
+#endif // PARALLEL_H_
@@ -7,10 +7,12 @@
 #include <list>
 #include <cctype>
 #include <math.h>
+#include <stdint.h>
 
 using namespace std;
 
 #include "polygon.h"
+#include "parallel.h"
 
 // #define DEBUG
 
@@ -32,6 +34,33 @@ inline Point roundDot(Point &p)
 	return Point(roundDot(p.x), roundDot(p.y));
 }
 
+/*
+ * 32.32 fixed point used to step the edges from one scan line to the next.
+ * roundFixed() rounds half away from zero, as roundDot() does.
+ */
+const double fixedOne = 4294967296.0;
+const int64_t fixedHalf = INT64_C(0x80000000);
+const int64_t fixedFraction = INT64_C(0xffffffff);
+const int notStepped = INT_MAX; // tolerance of an edge evaluated on every scan line
+const int minimumStepRows = 4;	// shorter edges are not worth the set up of stepping
+
+const size_t minimumBandIntersects = 65536;	// smaller polygons are scan converted on one thread
+const int minimumBandLines = 64;
+
+inline int64_t toFixed(double x)
+{
+	return int64_t(x < 0 ? x * fixedOne - 0.5 : x * fixedOne + 0.5);
+}
+
+inline int roundFixed(int64_t x)
+{
+	if (x < 0)
+	{
+		return -int((-x + fixedHalf) >> 32);
+	}
+	return int((x + fixedHalf) >> 32);
+}
+
 /*
  * The Edge object for defining information for an edge of a polygon.
  * Edge class is used by polygon scan line filling algorithm as implimented in Polygon::initialise().
@@ -45,7 +74,10 @@ public:
 	bool includeBottom;
 	double ymin;
 	double ymax;
+	double magnitude; // |x1 * delta_y| + |y1 * delta_x|, bounds the rounding error of C
 	int number; // used for debugging
+	int firstLine; // first and last scan lines crossed, from the polygon's first scan line
+	int lastLine;
 
 	// Define < to be used for sorting edges in a list of ascending ymin.
 	bool operator<(const Edge &rhs) const
@@ -65,6 +97,7 @@ public:
 		delta_y = p2.y - p1.y;
 
 		C = p1.x * delta_y - p1.y * delta_x;
+		magnitude = fabs(p1.x * delta_y) + fabs(p1.y * delta_x);
 	}
 
 	// Line equation to return x coordinate from y.
@@ -73,6 +106,34 @@ public:
 	{
 		return (y * delta_x + C) / delta_y; // delta_y should never be zero, as such Edges are excluded from Edge table
 	}
+
+	// Fixed point x coordinate at scan line y and its increment per scan line, for the next rows scan lines.
+	// tolerance bounds the difference between the stepped x and x(), so where the stepped x is further than
+	// tolerance from a rounding boundary, both round to the same pixel.
+	// Returns false when the edge is not worth stepping in fixed point: x() must be used on every scan line.
+	bool step(double y, int rows, int64_t &fixedX, int64_t &fixedStep, int &tolerance)
+	{
+		const double epsilon = 1.0 / 9007199254740992.0; // 2^-53, the relative rounding error of a double
+		if (rows < minimumStepRows)
+			return false;
+		double x0 = x(y);
+		double slope = delta_x / delta_y;
+		double maxY = max(fabs(ymin), fabs(ymax));
+		if (fabs(x0) + rows * fabs(slope) >= 1073741824.0) // 2^30, leaves headroom in 32.32 fixed point
+			return false;
+
+		// Error of x() on any of the scan lines, and of the stepping: rounding of x0 and of the slope,
+		// accumulated over the rows
+		double error = 16 * epsilon * (maxY * fabs(slope) + magnitude / fabs(delta_y)) + 4 * epsilon * (fabs(x0) + rows * fabs(slope));
+		error = 2 * error + 2 / fixedOne + rows * (1 / fixedOne + 2 * epsilon * fabs(slope));
+		if (error >= 0.25)
+			return false;
+
+		fixedX = toFixed(x0);
+		fixedStep = toFixed(slope);
+		tolerance = int(error * fixedOne) + 1;
+		return true;
+	}
 };
 
 /*
@@ -85,17 +146,137 @@ public:
 void Polygon::initialise()
 {
 	// the screen minimum and maximum values are the pixel ranges of the polygon when plotted to a bitmap.
-	pixelMinX = roundDot(vdata->minx + offset.x);
-	pixelMaxX = pixelMinX + vdata->pixelWidth;
+	// x intersections are rounded before pixelOffsetX is added, so the x limits are rounded the same way.
+	pixelOffsetX = roundDot(offset.x);
+	pixelMinX = pixelOffsetX + roundDot(vdata->minx);
+	pixelMaxX = pixelOffsetX + roundDot(vdata->maxx);
 	pixelMinY = roundDot(vdata->miny + offset.y);
 	pixelMaxY = pixelMinY + vdata->pixelHeigth;
-	pixelOffsetX = roundDot(offset.x);
+}
+
+void PolygonStore::add(const Polygon &polygon)
+{
+	Scan s;
+	s.pixelMinY = polygon.pixelMinY;
+	s.pixelMaxY = polygon.pixelMaxY;
+	s.pixelOffsetX = polygon.pixelOffsetX;
+	s.vdata = polygon.vdata;
+	scan.push_back(s);
+
+	Info i;
+	i.number = polygon.number;
+	i.polarity = polygon.polarity;
+	i.pixelMinX = polygon.pixelMinX;
+	i.pixelMaxX = polygon.pixelMaxX;
+	info.push_back(i);
+}
+
+/*
+ * Scan converts the scan lines firstLine to lastLine of a polygon, whose first scan line is at y0, from its edges
+ * sorted by ymin. Stores the number of x intersections of each scan line in counts and the sorted intersections
+ * in intersects, which must have room for all of them.
+ */
+static void scanBand(vector<Edge> &edges, double y0, int firstLine, int lastLine, int *counts, int *intersects)
+{
+	// Active edge list, with the x intersections of the current scan line. It is kept in ascending x so that
+	// on the next scan line, where the edges have hardly moved, an insertion sort restores the order cheaply.
+	// The intersections are stepped in fixed point, the line equation is only evaluated where the stepped
+	// value is too close to a rounding boundary to be sure of the pixel.
+	struct ActiveEdge
+	{
+		int64_t x;			// fixed point x on the current scan line
+		int64_t step;		// added to x for each scan line
+		int tolerance;		// see Edge::step(), or notStepped
+		int rows;			// number of scan lines left, including the current one
+		int pixel;			// x rounded as roundDot(edge->x(y))
+		Edge *edge;
+	};
+	vector<ActiveEdge> active;
+	vector<Edge>::iterator currentEdge = edges.begin();
+
+	// Run through the scan lines. Edges starting above the band join on its first scan line.
+	double y = y0 + firstLine;
+	for (int line = firstLine; line <= lastLine; line++, y += 1.0)
+	{
+		// Добавляем активные ребра в список
+		for (; currentEdge != edges.end() && currentEdge->firstLine <= line; currentEdge++)
+		{
+			if (currentEdge->lastLine < line)
+				continue;
+
+			ActiveEdge a;
+			a.edge = &*currentEdge;
+			a.rows = min(currentEdge->lastLine, lastLine) - line + 1;
+			if (!a.edge->step(y, a.rows, a.x, a.step, a.tolerance))
+			{
+				a.x = a.step = 0;
+				a.tolerance = notStepped;
+			}
+			a.x -= a.step; // stepped to this scan line below
+			active.push_back(a);
+		}
+
+		// Remove the finished edges from active list, and step the others to this scan line. The line equation
+		// is only evaluated for an edge not stepped, or when the stepped x is too close to a rounding boundary.
+		size_t kept = 0;
+		for (size_t i = 0; i < active.size(); i++)
+		{
+			ActiveEdge &a = active[i];
+			if (a.rows-- == 0)
+				continue;
+			if (a.tolerance != notStepped)
+			{
+				a.x += a.step;
+				int64_t fraction = (a.x < 0 ? -a.x : a.x) & fixedFraction;
+				if (uint64_t(fraction - fixedHalf + a.tolerance) <= uint64_t(2 * int64_t(a.tolerance)))
+					a.pixel = roundDot(a.edge->x(y)); // too close to a rounding boundary
+				else
+					a.pixel = roundFixed(a.x);
+			}
+			else
+			{
+				double x = a.edge->x(y);
+				a.x = toFixed(x); // to sort
+				a.pixel = roundDot(x);
+			}
+			if (kept != i)
+				active[kept] = a;
+			kept++;
+		}
+		active.resize(kept);
+
+		// Sort all x intersections for this scan line
+		for (size_t i = 1; i < active.size(); i++)
+		{
+			ActiveEdge a = active[i];
+			size_t j = i;
+			for (; j > 0 && a.x < active[j - 1].x; j--)
+				active[j] = active[j - 1];
+			active[j] = a;
+		}
+
+		int sliCount = int(active.size());
+		if (sliCount & 1)
+			throw string("Execution error. (polygon scan line data not even)");
+
+		*counts++ = sliCount;
+		for (int i = 0; i < sliCount; i++)
+		{
+			// Store intersect X point as integer. Two edges that close together can round in either order.
+			int x = active[i].pixel;
+			int j = i;
+			for (; j > 0 && x < intersects[j - 1]; j--)
+				intersects[j] = intersects[j - 1];
+			intersects[j] = x;
+		}
+		intersects += sliCount;
+	}
 }
 
 /*
  *  VertexData initialisation.
  *   - Sets min and max variables from vertex data.
- *   - Creates scan line intercept X data used for filling the polygon by scan line method.
+ *  The scan line data is only created by createScanLines(), when the polygon is about to be drawn.
  */
 void VertexData::initialise()
 {
@@ -129,14 +310,25 @@ void VertexData::initialise()
 
 	pixelHeigth = roundDot(maxy - miny);
 	pixelWidth = roundDot(maxx - minx);
+}
 
-	list<Edge> edges;
-	list<Edge *> active; // Active edge list. Points to the  edges that intersect the current scan line
+/*
+ *  Creates scan line intercept X data used for filling the polygon by scan line method.
+ *  Large polygons are split in horizontal bands scan converted on up to 'threads' threads.
+ *  initialise() shall be called first.
+ */
+void VertexData::createScanLines(unsigned threads)
+{
+	if (vertices.size() == 0)
+		return;
+
+	vector<Edge> edges;
+	edges.reserve(vertices.size());
 
 	Point p1 = vertices.back();
 
 	// Build Global Edges Table
-	// Edges are initially stored in list #edge in same order as polygon boundary path.
+	// Edges are initially stored in vector #edges in same order as polygon boundary path.
 	// All horizontal edges are excluded from table.
 	for (int i = 0; i < static_cast<int>(vertices.size()); i++)
 	{
@@ -152,9 +344,9 @@ void VertexData::initialise()
 	// Determine edges that have a bottom vertex which has higher y value than either of it's neighbouring vertices.
 	// Such edges are flagged includeBottom, so in the scan line loop, the edge is not removed from the active list
 	// until the very bottom of the edge is scanned. This prevents vertices and bottom horizontal lines being missed in the plot.
-	list<Edge>::iterator pit = edges.end();
+	vector<Edge>::iterator pit = edges.end();
 	pit--;
-	for (list<Edge>::iterator it = edges.begin(); it != edges.end(); it++)
+	for (vector<Edge>::iterator it = edges.begin(); it != edges.end(); it++)
 	{
 		// When this edge is pointing up (y1 > y2) and the previous edge pointing down (y2 > y1) then its a bottom
 		if ((it->delta_y < 0) && (pit->delta_y > 0))
@@ -169,57 +361,141 @@ void VertexData::initialise()
 	// Action: A single x1 x2 pair for horizontal line from polygon's minx to maxx at where y coordinate is at miny = maxy
 	if (pixelHeigth == 0)
 	{
-		linesInCounts.push_back(2);
-		gxIntersects.push_back(roundDot(minx));
-		gxIntersects.push_back(roundDot(maxx));
+		int counts[] = { 2 };
+		int intersects[] = { roundDot(minx), roundDot(maxx) };
+		encode(counts, 1, intersects, 2);
 		return;
 	}
 
 	// All edges in table are to be sorted with ascending ymin points.
-	edges.sort();
-	list<Edge>::iterator currentEdge = edges.begin();
+	stable_sort(edges.begin(), edges.end());
+
+	// Scan lines crossed by each edge. An edge joins the active list on the first scan line at or below ymin and
+	// stays in it down to its bottom. The bottom scan line itself is excluded to avoid double counting due to a
+	// joining edge below this edge, unless includeBottom.
+	double y0 = roundDot(miny) + 0.5;
+	size_t intersectsCount = 0;
+	for (vector<Edge>::iterator it = edges.begin(); it != edges.end(); it++)
+	{
+		double first = max(ceil(it->ymin - y0), 0.0);
+		while (first > 0 && y0 + first - 1 >= it->ymin)
+			first--;
+		while (y0 + first < it->ymin)
+			first++;
+		double y = y0 + first;
+		double last = floor(it->ymax - y);
+		while (last >= 0 && y + last > it->ymax)
+			last--;
+		while (y + last + 1 <= it->ymax)
+			last++;
+		if (y + last == it->ymax && !it->includeBottom)
+			last--;
+		it->firstLine = int(min(first, double(pixelHeigth) + 1));
+		it->lastLine = int(min(first + last, double(pixelHeigth)));
+		if (it->lastLine >= it->firstLine)
+			intersectsCount += it->lastLine - it->firstLine + 1;
+	}
+	vector<int> counts(pixelHeigth + 1);
+	vector<int> intersects(intersectsCount);
 
-	// Run through the scan lines
-	double y = roundDot(miny) + 0.5;
-	for (int linedc = pixelHeigth; linedc >= 0; linedc--, y += 1.0)
+	unsigned bands = 1;
+	if (intersectsCount >= minimumBandIntersects)
+		bands = unsigned(min<size_t>(threadCount(threads), counts.size() / minimumBandLines));
+	if (bands <= 1)
 	{
-		// Добавляем активные ребра в список
-		while (currentEdge != edges.end() && y >= (currentEdge->ymin))
-		{
-			active.push_back(&(*currentEdge));
-			currentEdge++;
-		}
+		scanBand(edges, y0, 0, pixelHeigth, counts.data(), intersects.data());
+		encode(counts.data(), counts.size(), intersects.data(), intersects.size());
+		return;
+	}
 
-		// Remove edges from active list
-		// When the scan line is equal to or greater than the bottom of the edge then it shall be removed.
-		// This avoids double counting due to a joining edge below this edge.
-		for (list<Edge *>::iterator it = active.begin(); it != active.end();)
+	// Split the scan lines in bands of about the same number of x intersections, and scan convert the bands
+	// concurrently, each straight into its part of the scan line data.
+	for (vector<Edge>::iterator it = edges.begin(); it != edges.end(); it++)
+	{
+		if (it->lastLine < it->firstLine)
+			continue;
+		counts[it->firstLine]++;
+		if (it->lastLine < pixelHeigth)
+			counts[it->lastLine + 1]--;
+	}
+	vector<int> bandLines(1, 0);
+	vector<size_t> bandOffsets(1, 0);
+	size_t sum = 0;
+	for (int line = 0, count = 0; line <= pixelHeigth; line++)
+	{
+		count += counts[line];
+		sum += count;
+		if (bandLines.size() < bands && sum >= intersectsCount * bandLines.size() / bands && line < pixelHeigth)
 		{
-			if (y > ((*it)->ymax) || (y == ((*it)->ymax) && !(*it)->includeBottom))
-			{
-				it = active.erase(it);
-				continue;
-			}
-			it++;
+			bandLines.push_back(line + 1);
+			bandOffsets.push_back(sum);
 		}
-		// printf(" y(%3f)  ", y);
-		for (list<Edge *>::iterator it = active.begin(); it != active.end(); it++)
+	}
+	bandLines.push_back(pixelHeigth + 1);
+	bandOffsets.push_back(intersectsCount);
+	parallelFor(bandLines.size() - 1, threads, [&](size_t b)
+	{
+		scanBand(edges, y0, bandLines[b], bandLines[b + 1] - 1, &counts[bandLines[b]], &intersects[0] + bandOffsets[b]);
+	});
+	encode(counts.data(), counts.size(), intersects.data(), intersects.size());
+}
+
+/*
+ * Stores the scan line data in compact form: the counts of x intersections as runs of scan lines with the same
+ * count, and the x intersections in 16 bits relative to the smallest one, when they all fit.
+ * intersects holds the x intersections of each scan line in ascending order.
+ */
+void VertexData::encode(const int *counts, size_t lines, const int *intersects, size_t intersectsCount)
+{
+	size_t runs = 0;
+	for (size_t i = 0; i < lines; i++)
+		if (i == 0 || counts[i] != counts[i - 1])
+			runs++;
+	lineCounts.reserve(runs);
+	for (size_t i = 0; i < lines; i++)
+	{
+		if (i == 0 || counts[i] != counts[i - 1])
 		{
-			int x = roundDot((*it)->x(y));
-			gxIntersects.push_back(x); // Store intersect X point as integer
-									   //			printf("%4d ", x );
+			LineRun run = { counts[i], 0 };
+			lineCounts.push_back(run);
 		}
-		//		printf("\n");
+		lineCounts.back().lines++;
+	}
 
-		int sliCount = active.size();
-		linesInCounts.push_back(sliCount);
+	// the first and last x of each scan line are its limits
+	int low = INT_MAX, high = INT_MIN;
+	const int *x = intersects;
+	for (size_t i = 0; i < lines; x += counts[i++])
+	{
+		if (counts[i] == 0)
+			continue;
+		low = min(low, x[0]);
+		high = max(high, x[counts[i] - 1]);
+	}
+	if (intersectsCount == 0 || int64_t(high) - low <= UINT16_MAX)
+	{
+		gxBase = intersectsCount ? low : 0;
+		gxIntersects16.resize(intersectsCount);
+		for (size_t i = 0; i < intersectsCount; i++)
+			gxIntersects16[i] = uint16_t(intersects[i] - gxBase);
+	}
+	else
+	{
+		gxBase = 0;
+		gxIntersects.assign(intersects, intersects + intersectsCount);
+	}
+}
 
-		if (sliCount & 1)
-			throw string("Execution error. (polygon scan line data not even)");
+// Bytes held by the scan line data
+size_t VertexData::scanLinesBytes() const
+{
+	return lineCounts.size() * sizeof(LineRun) + gxIntersects16.size() * sizeof(uint16_t) + gxIntersects.size() * sizeof(int);
+}
 
-		// Sort all x intersections for this scan line
-		sort(gxIntersects.end() - sliCount, gxIntersects.end());
-	}
+// Bytes the scan line data would take with an int for every count and x intersection
+size_t VertexData::plainScanLinesBytes() const
+{
+	return (pixelHeigth + 1 + gxIntersects16.size() + gxIntersects.size()) * sizeof(int);
 }
 
 #ifdef DEBUG
@@ -248,6 +524,16 @@ printf(" add %d\n", active.back()->number);
 printf("\n");
 #endif
 
+/*
+ * Frees the scan line data. It is created again by createScanLines() if needed.
+ */
+void VertexData::releaseScanLines()
+{
+	vector<LineRun>().swap(lineCounts);
+	vector<uint16_t>().swap(gxIntersects16);
+	vector<int>().swap(gxIntersects);
+}
+
 /*
  * Append a vertex to polygon's vertices list.
  */
@@ -2,7 +2,10 @@
 #define POLYGON_H_
 
 #include <limits.h>
+#include <stdint.h>
 #include <algorithm>
+#include <vector>
+#include "arena.h"
 
 /*  Constants used to specify how objects are to be plotted to the bitmap */
 typedef  enum {DARK, CLEAR, XOR} Polarity_t;
@@ -106,21 +109,38 @@ public:
  *
  * Polygons can have a common set of vertices and therefore much processing time is saved by sharing the vertices and
  * scan line filling process. Each polygon has individual data for screen positioning, screen limits and rotation.
+ * The scan line data is only held while polygons using it are being drawn.
  */
 class VertexData
 {
 private:
-	std::vector<int> gxIntersects;	// Vector of x coordinates that intersect each edge of polygon on consecutive scan lines
-    std::vector<int> linesInCounts;	// For each scan line, linesInCounts holds number of x intersections.
+	struct LineRun					// 'lines' consecutive scan lines with 'count' x intersections each
+	{
+		int count;
+		int lines;
+	};
+	// Scan line data, see encode(). The x intersections of all scan lines follow each other, in ascending x on
+	// each scan line, in gxIntersects16 relative to gxBase when they all fit in 16 bits, else in gxIntersects.
+	std::vector<LineRun> lineCounts;
+	std::vector<uint16_t> gxIntersects16;
+	std::vector<int> gxIntersects;
+	int gxBase;
 	Point lastVertex;
 	friend class Polygon;
+	friend class Rasterizer;
+	friend class PolygonStore;
 	int pixelHeigth;
 	int pixelWidth;
+	int users;						// polygons yet to be drawn with the scan line data, counted by the Rasterizer
+
+	void encode(const int *counts, size_t lines, const int *intersects, size_t intersectsCount);
 
 public:
 	std::vector<Point> vertices;	// All vertices in polygon
 	double minx, miny, maxx, maxy;
 
+	VertexData() : gxBase(0), pixelHeigth(0), pixelWidth(0), users(0) { }
+
 	bool empty()   	{ return (vertices.size()==0); }
 	void scale(double scaleX,  double scaleY );
 	void rotate( double radian);
@@ -131,6 +151,11 @@ public:
 	void addRegularPolygon( double face_radius, double start_angle, int num_sides, double x0=0, double y0=0);
 	void addRectangle( double x_size, double y_size, double x0=0, double y0=0);
 	void initialise();
+	void createScanLines(unsigned threads = 1);	// threads: 0 for one per processor
+	void releaseScanLines();
+	bool hasScanLines() const	{ return !lineCounts.empty(); }
+	size_t scanLinesBytes() const;
+	size_t plainScanLinesBytes() const;
 };
 
 
@@ -141,10 +166,6 @@ public:
  */
 class Polygon
 {
-private:
-	int * nextInTable;
-	int * nextInCount;
-
 public:
 	VertexData * vdata;
 	int pixelMinX, pixelMinY, pixelMaxX, pixelMaxY;
@@ -154,10 +175,8 @@ public:
 	int number;										// used to sort order of creation of polygons
 	Polarity_t polarity;							// The plotting polarity
 
-	Polygon () 
-		: nextInTable(0)
-		, nextInCount(0)
-		, vdata(new VertexData)
+	explicit Polygon (Arena &arena)		// the polygon's vertices are owned by arena
+		: vdata(arena.create<VertexData>())
 		, pixelMinX(0), pixelMinY(0), pixelMaxX(0), pixelMaxY(0)
 		, pixelOffsetX(0)
 		, offset(0,0)
@@ -166,44 +185,63 @@ public:
 	{ }
 
 	void initialise();
-	std::vector<int> const & getNextLineX1X2Pairs();
 	bool empty()   	{ return vdata->empty(); }
-	bool operator<(const Polygon &rhs) const
-	{
-		return pixelMinY < rhs.pixelMinY;
-	}
+};
 
-	/*
-	 * Each call will return the polygon edge intercepting data for the next scan line. The first call will be for the first scan line of
-	 * the polygon.    Used for plotting filled polygon to a bitmap. Horizontal lines are to be drawn between each odd and even pair in the
-	 * x intercept data pointed to by sliTable.
-	 */
-	void getNextLineX1X2Pairs(int * &sliTable, int &sliCount )
-	{
-		 // Resets the scan line counters to zero  on first call to this function
-		if (nextInCount == 0)
-		{
-			nextInCount = &vdata->linesInCounts.front();
-			nextInTable = &vdata->gxIntersects.front();
-		}
 
-		sliCount = *nextInCount;
-		sliTable = nextInTable;
-		nextInTable += sliCount;
-		nextInCount++;
-	}
+/*
+ * PolygonStore holds the initialised polygons of an image, sorted by first scan line.
+ *
+ * The fields are split in two contiguous groups so that the rasterizer walks them in sequence: the scan group is
+ * read on every scan line, the info group once when the polygon is activated or the image limits computed.
+ */
+class PolygonStore
+{
+public:
+	struct Scan
+	{
+		int pixelMinY, pixelMaxY;
+		int pixelOffsetX;
+		VertexData *vdata;				// scan line data, created when the polygon is reached
+	};
+	struct Info
+	{
+		int number;						// order of creation
+		Polarity_t polarity;
+		int pixelMinX, pixelMaxX;
+	};
+
+	std::vector<Scan> scan;
+	std::vector<Info> info;
+
+	size_t size() const	{ return scan.size(); }
+	bool empty() const	{ return scan.empty(); }
+	void reserve(size_t count)	{ scan.reserve(count); info.reserve(count); }
+	void add(const Polygon &polygon);	// polygon must be initialised, and added in order of first scan line
 };
 
 
+/*
+ * The polygons of a flashed aperture, including all apertures of a composite macro, in drawing order.
+ * A Shape is built on the first flash of an aperture and shared by all of its flashes.
+ */
+struct Shape
+{
+	const Polygon *polygons;		// not empty, offset (0,0)
+	int count;
+};
 
-class PolygonReference
+/*
+ * A flash of a Shape. Flashes are not copied into polygons: the Rasterizer expands them into the
+ * polygons of their shape only while they are being drawn.
+ */
+struct Flash
 {
-public:
-	Polygon *polygon;
-	bool operator<( const PolygonReference &rhs) const
-	{
-		return polygon->number < rhs.polygon->number;
-	}
+	const Shape *shape;
+	Point offset;					// position of the flash in pixels
+	int number;						// drawing order of the shape's first polygon, the other polygons follow it
+	int pixelMinX, pixelMinY, pixelMaxX, pixelMaxY;	// pixel limits of the shape's polygons at the flash
+	bool isClear;					// drawn with %LPC*% in effect, all polygons are CLEAR
 };
 
 
@@ -0,0 +1,232 @@
+// This file is distributed under the terms of the GNU General Public License v3.
+
+#include <limits.h>
+#include <math.h>
+#include <algorithm>
+#include <vector>
+
+#include "polygon.h"
+#include "apertures.h"
+#include "gerber.h"
+#include "rasterizer.h"
+
+Rasterizer::Rasterizer(unsigned threads)
+	: polarities(0), threads(threads), minx(INT_MAX), miny(INT_MAX), maxx(INT_MIN), maxy(INT_MIN), polygonCount(0)
+	, isOrdered(false)
+	, scanLinesBytes(0), peakScanLinesBytes(0), createdScanLinesBytes(0), plainScanLinesBytes(0)
+{
+}
+
+//
+// Gives back the scan line data of the polygons not drawn to their end, so the Gerber objects can be drawn again.
+//
+Rasterizer::~Rasterizer()
+{
+	for (size_t i = 0; i < active.size(); i++)
+		release(active[i].vdata);
+	for (size_t s = 0; s < sources.size(); s++)
+	{
+		const Source &source = sources[s];
+		for (size_t p = source.nextPolygon; p < source.polygons->size(); p++)
+			release(source.polygons->scan[p].vdata);
+		for (size_t f = source.nextFlash; f < source.flashes->size(); f++)
+		{
+			const Shape *shape = (*source.flashes)[f].shape;
+			for (int k = 0; k < shape->count; k++)
+				release(shape->polygons[k].vdata);
+		}
+	}
+}
+
+//
+// Adds the polygons and flashes of a parsed Gerber object, drawn after those of the Gerber objects already added
+// when their drawing order is the same. All must be added before drawing.
+//
+void Rasterizer::add(Gerber &gerber)
+{
+	Source source;
+	source.polygons = &gerber.store;
+	source.nextPolygon = 0;
+	source.flashes = &gerber.flashes;
+	source.nextFlash = 0;
+	sources.push_back(source);
+
+	const PolygonStore &store = gerber.store;
+	for (size_t p = 0; p < store.size(); p++)
+	{
+		include(store.info[p].pixelMinX, store.scan[p].pixelMinY, store.info[p].pixelMaxX, store.scan[p].pixelMaxY);
+		store.scan[p].vdata->users++;
+		polarities |= 1u << store.info[p].polarity;
+	}
+	polygonCount += store.size();
+	for (size_t f = 0; f < gerber.flashes.size(); f++)
+	{
+		const Flash &flash = gerber.flashes[f];
+		include(flash.pixelMinX, flash.pixelMinY, flash.pixelMaxX, flash.pixelMaxY); // worked out by the parser
+		for (int k = 0; k < flash.shape->count; k++)
+		{
+			flash.shape->polygons[k].vdata->users++;
+			polarities |= 1u << (flash.isClear ? CLEAR : flash.shape->polygons[k].polarity);
+		}
+		polygonCount += flash.shape->count;
+	}
+	isOrdered = (polarities & (polarities - 1)) != 0; // more than one
+}
+
+// extends the image limits to a polygon or flash
+void Rasterizer::include(int pixelMinX, int pixelMinY, int pixelMaxX, int pixelMaxY)
+{
+	if (minx > pixelMinX)
+		minx = pixelMinX;
+	if (maxx < pixelMaxX)
+		maxx = pixelMaxX;
+	if (miny > pixelMinY)
+		miny = pixelMinY;
+	if (maxy < pixelMaxY)
+		maxy = pixelMaxY;
+}
+
+//
+// Moves the polygons and flashes starting at or before scan line y into the active list. They are appended and,
+// if the drawing order is kept, sorted on their own, usually a few, then merged with the polygons already active,
+// coming after those of the same drawing order.
+//
+void Rasterizer::activate(int y)
+{
+	size_t count = active.size();
+	for (size_t s = 0; s < sources.size(); s++)
+	{
+		Source &source = sources[s];
+		const PolygonStore &store = *source.polygons;
+		for (; source.nextPolygon < store.size() && store.scan[source.nextPolygon].pixelMinY <= y; source.nextPolygon++)
+		{
+			const PolygonStore::Scan &scan = store.scan[source.nextPolygon];
+			Active entry;
+			entry.number = store.info[source.nextPolygon].number;
+			entry.firstY = scan.pixelMinY;
+			entry.source = int(s);
+			entry.lastY = scan.pixelMaxY;
+			entry.offsetX = scan.pixelOffsetX;
+			entry.polarity = store.info[source.nextPolygon].polarity;
+			use(entry, scan.vdata);
+			active.push_back(entry);
+		}
+		for (; source.nextFlash < source.flashes->size() && (*source.flashes)[source.nextFlash].pixelMinY <= y; source.nextFlash++)
+		{
+			const Flash &flash = (*source.flashes)[source.nextFlash];
+			for (int k = 0; k < flash.shape->count; k++)
+			{
+				Polygon polygon = flash.shape->polygons[k];
+				polygon.offset = flash.offset;
+				polygon.initialise();
+				polygon.number = flash.number + k;
+				activate(polygon, int(s), flash.isClear ? CLEAR : polygon.polarity);
+			}
+		}
+	}
+	if (active.size() == count || !isOrdered)
+		return;
+	std::stable_sort(active.begin() + count, active.end());
+	std::inplace_merge(active.begin(), active.begin() + count, active.end());
+}
+
+void Rasterizer::activate(const Polygon &polygon, int source, Polarity_t polarity)
+{
+	Active entry;
+	entry.number = polygon.number;
+	entry.firstY = polygon.pixelMinY;
+	entry.source = source;
+	entry.lastY = polygon.pixelMaxY;
+	entry.offsetX = polygon.pixelOffsetX;
+	entry.polarity = polarity;
+	use(entry, polygon.vdata);
+	active.push_back(entry);
+}
+
+// points the entry at the scan line data, created by the first polygon using it
+void Rasterizer::use(Active &entry, VertexData *vdata)
+{
+	if (!vdata->hasScanLines())
+	{
+		vdata->createScanLines(threads);
+		scanLinesBytes += vdata->scanLinesBytes();
+		peakScanLinesBytes = std::max(peakScanLinesBytes, scanLinesBytes);
+		createdScanLinesBytes += vdata->scanLinesBytes();
+		plainScanLinesBytes += vdata->plainScanLinesBytes();
+	}
+	entry.offsetX += vdata->gxBase;
+	entry.intersects16 = vdata->gxIntersects16.empty() ? 0 : vdata->gxIntersects16.data();
+	entry.intersects = vdata->gxIntersects.data();
+	entry.run = vdata->lineCounts.data();
+	entry.runLeft = entry.run->lines;
+	entry.nextY = entry.firstY;
+	entry.vdata = vdata;
+}
+
+// moves the scan line data of the entry forward to scan line y
+void Rasterizer::skip(Active &entry, int y)
+{
+	for (int lines = y - entry.nextY; lines > 0;)
+	{
+		if (entry.runLeft == 0)
+			entry.runLeft = (++entry.run)->lines;
+		int n = std::min(lines, entry.runLeft);
+		size_t count = size_t(n) * entry.run->count;
+		if (entry.intersects16)
+			entry.intersects16 += count;
+		else
+			entry.intersects += count;
+		entry.runLeft -= n;
+		entry.nextY += n;
+		lines -= n;
+	}
+}
+
+//
+// Besides the polygons, the strip gets the ones starting on each of its scan lines, so that drawing a scan line
+// only looks at the polygons crossing it.
+//
+void Rasterizer::prepare(int firstY, int lastY, Strip &strip)
+{
+	activate(lastY);
+	strip.polygons.clear();
+	strip.isOrdered = isOrdered;
+	strip.firstY = firstY;
+	strip.starts.assign(size_t(std::max(lastY - firstY + 1, 0)) + 2, 0); // none past the image, in its border
+	size_t kept = 0;
+	for (size_t i = 0; i < active.size(); i++)
+	{
+		if (firstY > active[i].lastY)
+		{
+			release(active[i].vdata);
+			continue;
+		}
+		if (active[i].firstY <= lastY) // not a polygon of a flash starting below its first scan line
+		{
+			skip(active[i], firstY);
+			strip.polygons.push_back(active[i]);
+			strip.starts[std::max(active[i].firstY - firstY, 0) + 2]++;
+			active[i].vdata->users++; // held by the strip until finished
+		}
+		if (kept != i)
+			active[kept] = active[i];
+		kept++;
+	}
+	active.resize(kept);
+
+	// Counting sort by first scan line. The polygons are counted two places on, so that placing them moves the
+	// start of each scan line into its place.
+	for (size_t row = 2; row < strip.starts.size(); row++)
+		strip.starts[row] += strip.starts[row - 1];
+	strip.starting.resize(strip.polygons.size());
+	for (size_t i = 0; i < strip.polygons.size(); i++)
+		strip.starting[strip.starts[std::max(strip.polygons[i].firstY - firstY, 0) + 1]++] = unsigned(i);
+	strip.current.clear();
+}
+
+void Rasterizer::finish(Strip &strip)
+{
+	for (size_t i = 0; i < strip.polygons.size(); i++)
+		release(strip.polygons[i].vdata);
+	strip.polygons.clear();
+}
@@ -0,0 +1,210 @@
+// This file is distributed under the terms of the GNU General Public License v3.
+
+#ifndef RASTERIZER_H_
+#define RASTERIZER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "polygon.h"
+
+class Gerber;
+
+/*
+ * Rasterizer produces the horizontal spans of each scan line of one or more overlaid Gerber images.
+ *
+ * Scan lines must be requested in increasing y. Polygons join the active list on their first scan line and
+ * leave it after their last one. Flashes are expanded into the polygons of their shape when they are reached.
+ * The active list is kept in drawing order: polygon number, then first scan line, then order of the Gerber
+ * images, so the spans of a scan line can be drawn one after the other. The polygons joining it on a scan line
+ * are sorted on their own and merged in, and those leaving it are dropped while drawing, so rows where
+ * thousands of pads start cost no more than the pads.
+ *
+ * When all polygons have the same polarity, the spans of a scan line draw the same pixels in any order. The
+ * polygons are then left in the order they join the active list, which follows the order they lie in memory,
+ * and are never sorted. Images with clear polygons, such as %LPC*% layers, clear macro primitives and aperture
+ * holes, keep the drawing order.
+ *
+ * The scan line data of a polygon is created when the polygon joins the active list, and released once the
+ * last polygon or flash sharing it has left, so only the polygons around the current scan line hold any.
+ * A Gerber object can only be drawn by one Rasterizer at a time.
+ *
+ * Instead of scanLine(), the image can be drawn in strips of consecutive scan lines. prepare() gives a strip the
+ * polygons crossing it, positioned at its first scan line, so strips can then be drawn in any order on different
+ * threads while the next ones are prepared. Strips hold on to their scan line data until finish().
+ */
+class Rasterizer
+{
+private:
+	struct Source							// polygons and flashes of one Gerber object, sorted by first scan line
+	{
+		const PolygonStore *polygons;
+		size_t nextPolygon;
+		const std::vector<Flash> *flashes;
+		size_t nextFlash;
+	};
+
+	struct Active							// a polygon being drawn
+	{
+		int number;
+		int firstY;
+		int source;
+		int lastY;
+		int offsetX;						// added to the x intersections
+		Polarity_t polarity;
+		const uint16_t *intersects16;		// x intersections of the next scan line, 16 bits or int
+		const int *intersects;
+		const VertexData::LineRun *run;		// number of x intersections of the next scan line
+		int runLeft;						// scan lines left in run
+		int nextY;							// scan line of intersects and run
+		VertexData *vdata;					// owner of the scan line data
+
+		bool operator<(const Active &rhs) const
+		{
+			if (number != rhs.number)
+				return number < rhs.number;
+			if (firstY != rhs.firstY)
+				return firstY < rhs.firstY;
+			return source < rhs.source;
+		}
+	};
+
+	std::vector<Source> sources;
+	std::vector<Active> active;				// in drawing order, or in the order they joined if not isOrdered
+	unsigned polarities;					// bit set of the polarities of all polygons
+	unsigned threads;						// threads creating the scan line data of large polygons
+
+	Rasterizer(const Rasterizer &);			// not copyable
+	Rasterizer &operator=(const Rasterizer &);
+
+	void activate(int y);
+	void activate(const Polygon &polygon, int source, Polarity_t polarity);
+	void use(Active &entry, VertexData *vdata);
+	static void skip(Active &entry, int y);
+	void include(int pixelMinX, int pixelMinY, int pixelMaxX, int pixelMaxY);
+
+	// one user less of the scan line data, released after the last one
+	void release(VertexData *vdata)
+	{
+		if (--vdata->users == 0)
+		{
+			scanLinesBytes -= vdata->scanLinesBytes();
+			vdata->releaseScanLines();
+		}
+	}
+
+	// Calls draw(x1, x2, polarity) for every span of the entry's next scan line, and moves to the one after.
+	template <class Draw>
+	static void drawLine(Active &entry, Draw &draw)
+	{
+		if (entry.runLeft == 0)
+			entry.runLeft = (++entry.run)->lines;
+		entry.runLeft--;
+		entry.nextY++;
+		int count = entry.run->count;
+		if (entry.intersects16)
+		{
+			const uint16_t *x = entry.intersects16;
+			entry.intersects16 += count;
+			if (count == 2) // most scan lines of most polygons
+				draw(entry.offsetX + x[0], entry.offsetX + x[1], entry.polarity);
+			else
+				for (int i = 0; i < count; i += 2)
+					draw(entry.offsetX + x[i], entry.offsetX + x[i + 1], entry.polarity);
+		}
+		else
+		{
+			const int *x = entry.intersects;
+			entry.intersects += count;
+			for (int i = 0; i < count; i += 2)
+				draw(entry.offsetX + x[i], entry.offsetX + x[i + 1], entry.polarity);
+		}
+	}
+
+public:
+	// Scan lines firstY to lastY of the image, see prepare()
+	class Strip
+	{
+	private:
+		friend class Rasterizer;
+		std::vector<Active> polygons;		// polygons crossing the strip in drawing order
+		bool isOrdered;
+		int firstY;
+		std::vector<unsigned> starting;		// polygons by first scan line in the strip, each line in drawing order
+		std::vector<size_t> starts;			// first of starting on each scan line, and the end
+		std::vector<unsigned> current;		// polygons crossing the last scan line drawn, in drawing order
+		std::vector<unsigned> next;
+
+	public:
+		Strip() : isOrdered(true), firstY(0) { }
+
+		// Calls draw(x1, x2, polarity) for every span of scan line y, in drawing order. Scan lines must be
+		// requested one after the other from the first scan line of the strip.
+		template <class Draw>
+		void scanLine(int y, Draw draw)
+		{
+			// merge the polygons starting on the line with those still crossing it, or just add them
+			size_t row = size_t(y - firstY);
+			const unsigned *start = starting.data() + starts[row], *end = starting.data() + starts[row + 1];
+			next.clear();
+			for (size_t i = 0; i < current.size(); i++)
+			{
+				if (y > polygons[current[i]].lastY)
+					continue;
+				for (; isOrdered && start < end && *start < current[i]; start++)
+					next.push_back(*start);
+				next.push_back(current[i]);
+			}
+			next.insert(next.end(), start, end);
+			current.swap(next);
+
+			for (size_t i = 0; i < current.size(); i++)
+				drawLine(polygons[current[i]], draw);
+		}
+	};
+
+	int minx, miny, maxx, maxy;				// pixel limits of all polygons
+	size_t polygonCount;					// number of polygons, flashes counted by the polygons of their shape
+	bool isOrdered;							// spans drawn in drawing order, not needed with a single polarity
+
+	// Scan line data statistics, in bytes
+	size_t scanLinesBytes;					// held now
+	size_t peakScanLinesBytes;				// most held at any time
+	size_t createdScanLinesBytes;			// created in total
+	size_t plainScanLinesBytes;				// as above with an int for every count and x intersection
+
+	explicit Rasterizer(unsigned threads = 1);
+	~Rasterizer();
+	void add(Gerber &gerber);				// the Gerber object must live as long as the Rasterizer
+	bool empty() const { return polygonCount == 0; }
+
+	// Sets strip up to draw scan lines firstY to lastY on its own. Strips must be prepared in increasing y, and
+	// finished once drawn.
+	void prepare(int firstY, int lastY, Strip &strip);
+	void finish(Strip &strip);
+
+	// Calls draw(x1, x2, polarity) for every span of scan line y, in drawing order.
+	template <class Draw>
+	void scanLine(int y, Draw draw)
+	{
+		activate(y);
+		size_t kept = 0;
+		for (size_t i = 0; i < active.size(); i++)
+		{
+			if (y > active[i].lastY)
+			{
+				release(active[i].vdata);
+				continue;
+			}
+			if (y >= active[i].firstY)
+				drawLine(active[i], draw);
+			if (kept != i)
+				active[kept] = active[i];
+			kept++;
+		}
+		active.resize(kept);
+	}
+};
+
+#endif // RASTERIZER_H_
@@ -0,0 +1,203 @@
+// This file is distributed under the terms of the GNU General Public License v3.
+
+#ifndef ROW_RUNS_H_
+#define ROW_RUNS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+
+#include "polygon.h"
+
+/*
+ * RowRuns is one row of a monochrome image kept as the pixels where the colour changes, instead of a bitmap.
+ *
+ * The changes are the increasing x coordinates of the pixels whose colour differs from the pixel on their left,
+ * the row starting white at x = 0, as CCITT encoding calls them changing elements. Spans are drawn on the row
+ * like fillSpans() draws them on a bitmap, so the changes end up describing the same pixels.
+ *
+ * Spans are only collected until the changes are read, then resolved in one pass, so overlapping spans cost
+ * nothing more than their sorting: rows of dense boards get hundreds of them. Spans of one polarity drawn one
+ * after the other form a layer, whose pixels are the same in any order. Each pixel takes the colour of the last
+ * layer covering it. XOR spans are drawn at once instead.
+ */
+class RowRuns
+{
+private:
+	std::vector<int> changes;
+	std::vector<int> merged;					// changes being merged with the spans
+	std::vector<uint64_t> spans;				// pixels x1 to x2 - 1 still to be set to one colour, x1 on top
+	std::vector<size_t> layers;					// first span of each layer
+	std::vector<bool> isLayerBlack;				// colour of the spans of each layer
+	std::vector<uint64_t> events;				// sweep over the layers: x on top, then layer, then 1 for a start
+	std::vector<int> coverage;					// spans of each layer over the sweep position
+	std::vector<int> top;						// heap of the covering layers, some maybe no more covering
+	int width;
+
+	// sets the pixels of the spans of one colour
+	void merge(bool isBlack)
+	{
+		std::sort(spans.begin(), spans.end());
+		merged.clear();
+		size_t k = 0;
+		for (size_t i = 0; i < spans.size();)
+		{
+			// join the spans overlapping or touching this one
+			int x1 = int(spans[i] >> 32), x2 = int(uint32_t(spans[i]));
+			for (i++; i < spans.size() && int(spans[i] >> 32) <= x2; i++)
+				x2 = std::max(x2, int(uint32_t(spans[i])));
+
+			// keep the changes left of the span, drop the ones in it, and change the colour at its ends if needed
+			for (; k < changes.size() && changes[k] < x1; k++)
+				merged.push_back(changes[k]);
+			if (bool(k & 1) != isBlack)
+				merged.push_back(x1);
+			for (; k < changes.size() && changes[k] <= x2; k++)
+				;
+			if (bool(k & 1) != isBlack && x2 < width)
+				merged.push_back(x2);
+		}
+		merged.insert(merged.end(), changes.begin() + k, changes.end());
+		changes.swap(merged);
+	}
+
+	//
+	// Sets the pixels of layers of different colours at once. Sweeping along the row, each pixel gets the colour
+	// of the last layer covering it, or keeps its own if none does.
+	//
+	void sweep()
+	{
+		events.clear();
+		for (size_t layer = 0; layer < layers.size(); layer++)
+		{
+			size_t end = layer + 1 < layers.size() ? layers[layer + 1] : spans.size();
+			for (size_t i = layers[layer]; i < end; i++)
+			{
+				events.push_back((spans[i] >> 32 << 32) | layer << 1 | 1);
+				events.push_back(spans[i] << 32 | layer << 1);
+			}
+		}
+		std::sort(events.begin(), events.end());
+		coverage.assign(layers.size(), 0);
+		top.clear();
+		merged.clear();
+
+		bool isBlack = false, isRowBlack = false;		// colour drawn so far and colour of the row underneath
+		size_t k = 0;
+		for (size_t e = 0; k < changes.size() || e < events.size();)
+		{
+			int x = k < changes.size() ? changes[k] : width;
+			if (e < events.size())
+				x = std::min(x, int(events[e] >> 32));
+			if (x >= width)
+				break;
+			if (k < changes.size() && changes[k] == x)
+			{
+				isRowBlack = !isRowBlack;
+				k++;
+			}
+			for (; e < events.size() && int(events[e] >> 32) == x; e++)
+			{
+				int layer = int(uint32_t(events[e]) >> 1);
+				if (!(events[e] & 1))
+					coverage[layer]--;
+				else if (coverage[layer]++ == 0)
+				{
+					top.push_back(layer);
+					std::push_heap(top.begin(), top.end());
+				}
+			}
+			while (!top.empty() && coverage[top.front()] == 0)
+			{
+				std::pop_heap(top.begin(), top.end());
+				top.pop_back();
+			}
+			bool isNowBlack = top.empty() ? isRowBlack : bool(isLayerBlack[top.front()]);
+			if (isNowBlack != isBlack)
+			{
+				merged.push_back(x);
+				isBlack = isNowBlack;
+			}
+		}
+		changes.swap(merged);
+	}
+
+	// sets the pixels of the spans collected so far
+	void flush()
+	{
+		if (spans.empty())
+			return;
+		if (layers.size() == 1)
+			merge(isLayerBlack[0]);
+		else
+			sweep();
+		spans.clear();
+		layers.clear();
+		isLayerBlack.clear();
+	}
+
+	// inverts the colour of the pixels from x on
+	void toggle(int x)
+	{
+		if (x >= width)
+			return;
+		std::vector<int>::iterator it = std::lower_bound(changes.begin(), changes.end(), x);
+		if (it != changes.end() && *it == x)
+			changes.erase(it);
+		else
+			changes.insert(it, x);
+	}
+
+public:
+	RowRuns() : width(0) { }
+
+	// Starts a new row of 'width' pixels of one colour.
+	void reset(int width, bool isBlack)
+	{
+		this->width = width;
+		changes.clear();
+		spans.clear();
+		if (isBlack)
+			changes.push_back(0);
+	}
+
+	// Draws pixels x1 to x2 as fillSpans() does: DARK makes them black, CLEAR white and XOR inverts them.
+	// Pixels outside the row are left out.
+	void draw(int x1, int x2, Polarity_t polarity)
+	{
+		if (x1 > x2)
+			std::swap(x1, x2);
+		x1 = std::max(x1, 0);
+		x2 = std::min(x2 + 1, width);
+		if (x1 >= x2)
+			return;
+		if (polarity == XOR)
+		{
+			flush();
+			toggle(x1);
+			toggle(x2);
+			return;
+		}
+		if (layers.empty() || isLayerBlack.back() != (polarity == DARK))
+		{
+			layers.push_back(spans.size());
+			isLayerBlack.push_back(polarity == DARK);
+		}
+		spans.push_back(uint64_t(x1) << 32 | unsigned(x2));
+	}
+
+	const int *data() { flush(); return changes.data(); }
+	size_t size() { flush(); return changes.size(); }
+
+	unsigned blackPixels()
+	{
+		flush();
+		unsigned count = 0;
+		for (size_t i = 0; i < changes.size(); i += 2)
+			count += (i + 1 < changes.size() ? changes[i + 1] : width) - changes[i];
+		return count;
+	}
+};
+
+#endif // ROW_RUNS_H_
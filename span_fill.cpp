@@ -0,0 +1,231 @@
+// This file is distributed under the terms of the GNU General Public License v3.
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAVE_AVX2_KERNEL
+#endif
+
+#include "span_fill.h"
+
+namespace
+{
+	// 64 pixels as stored in memory, turned to have the first one in the top bit, or back
+	inline uint64_t rowOrder(uint64_t word)
+	{
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+		return __builtin_bswap64(word);
+#else
+		return word;
+#endif
+	}
+
+	// change of the pixels selected by mask
+	template <Polarity_t P, class T>
+	inline T apply(T pixels, T mask)
+	{
+		if (P == DARK)
+			return pixels | mask;
+		if (P == CLEAR)
+			return pixels & ~mask;
+		return pixels ^ mask;
+	}
+
+	template <Polarity_t P>
+	inline void applyWord(unsigned char *p, uint64_t mask)
+	{
+		uint64_t word;
+		memcpy(&word, p, sizeof(word));
+		word = apply<P>(word, rowOrder(mask));
+		memcpy(p, &word, sizeof(word));
+	}
+
+	template <Polarity_t P>
+	inline void fillWord(unsigned char *p)
+	{
+		uint64_t word = P == DARK ? ~uint64_t(0) : 0;
+		if (P == XOR)
+		{
+			memcpy(&word, p, sizeof(word));
+			word = ~word;
+		}
+		memcpy(p, &word, sizeof(word));
+	}
+
+	// A few whole words with straight stores, as a loop would be turned into a memset() call costing more
+	template <Polarity_t P>
+	inline void fillWords(unsigned char *p, int words)
+	{
+		switch (words)
+		{
+		case 8: fillWord<P>(p + 56); // fall through
+		case 7: fillWord<P>(p + 48); // fall through
+		case 6: fillWord<P>(p + 40); // fall through
+		case 5: fillWord<P>(p + 32); // fall through
+		case 4: fillWord<P>(p + 24); // fall through
+		case 3: fillWord<P>(p + 16); // fall through
+		case 2: fillWord<P>(p + 8); // fall through
+		case 1: fillWord<P>(p);
+		}
+	}
+
+	// Whole words of a long span. Pixels are set or cleared by memset(), which the C library tunes for the
+	// processor, and inverted a word at a time.
+	template <Polarity_t P>
+	struct Words
+	{
+		static void fill(unsigned char *p, size_t bytes)
+		{
+			if (P != XOR)
+				memset(p, P == DARK ? 0xff : 0x00, bytes);
+			else
+				for (size_t i = 0; i < bytes; i += 8)
+					fillWord<P>(p + i);
+		}
+	};
+
+#ifdef HAVE_AVX2_KERNEL
+	// as Words, inverting 256 pixels at a time
+	template <Polarity_t P>
+	struct WordsAvx2
+	{
+		__attribute__((target("avx2"))) static void fill(unsigned char *p, size_t bytes)
+		{
+			if (P != XOR)
+			{
+				memset(p, P == DARK ? 0xff : 0x00, bytes);
+				return;
+			}
+			const __m256i ones = _mm256_set1_epi8(-1);
+			size_t i = 0;
+			for (; i + 32 <= bytes; i += 32)
+			{
+				__m256i *v = (__m256i *)(p + i);
+				_mm256_storeu_si256(v, _mm256_xor_si256(_mm256_loadu_si256(v), ones));
+			}
+			for (; i < bytes; i += 8)
+				fillWord<P>(p + i);
+		}
+	};
+#endif
+
+	//
+	// Draws the spans with the polarity and the whole word filling chosen at compile time. The row is split into
+	// the 64 bit words that fit in its bytes, and the last few bytes that don't.
+	//
+	template <Polarity_t P, class W>
+	void fillRow(unsigned char *row, int width, const int *spans, size_t count)
+	{
+		int wordEnd = (width + 7) / 64 * 64;		// first pixel past the words
+		for (size_t i = 0; i < count; i++)
+		{
+			int x1 = spans[2 * i], x2 = spans[2 * i + 1];
+			if (x1 > x2)
+				std::swap(x1, x2);
+			x1 = std::max(x1, 0);
+			x2 = std::min(x2, width - 1);
+
+			if (x1 < wordEnd && x1 <= x2)
+			{
+				int end = std::min(x2, wordEnd - 1);
+				int w1 = x1 >> 6, w2 = end >> 6;
+				uint64_t first = ~uint64_t(0) >> (x1 & 63);
+				uint64_t last = ~uint64_t(0) << (63 - (end & 63));
+				if (w1 == w2)
+					applyWord<P>(row + 8 * w1, first & last);
+				else
+				{
+					applyWord<P>(row + 8 * w1, first);
+					if (w2 - w1 - 1 <= 8)
+						fillWords<P>(row + 8 * (w1 + 1), w2 - w1 - 1);
+					else
+						W::fill(row + 8 * (w1 + 1), 8 * size_t(w2 - w1 - 1));
+					applyWord<P>(row + 8 * w2, last);
+				}
+				x1 = end + 1;
+			}
+			for (; x1 <= x2; x1 = (x1 | 7) + 1)		// last bytes of the row
+			{
+				unsigned mask = (0xffu >> (x1 & 7)) & (0xff00u >> ((std::min(x2, x1 | 7) & 7) + 1));
+				row[x1 >> 3] = apply<P>(row[x1 >> 3], (unsigned char)mask);
+			}
+		}
+	}
+
+	const size_t minCoalescedLength = 2048;		// average span length in pixels for RowPainter to resolve a row
+
+	typedef void FillRow(unsigned char *row, int width, const int *spans, size_t count);
+
+	// the kernels of each polarity for this processor
+	struct Kernels
+	{
+		FillRow *fill[3];
+
+		Kernels()
+		{
+			fill[DARK] = fillRow<DARK, Words<DARK> >;
+			fill[CLEAR] = fillRow<CLEAR, Words<CLEAR> >;
+			fill[XOR] = fillRow<XOR, Words<XOR> >;
+#ifdef HAVE_AVX2_KERNEL
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("avx2"))
+			{
+				fill[DARK] = fillRow<DARK, WordsAvx2<DARK> >;
+				fill[CLEAR] = fillRow<CLEAR, WordsAvx2<CLEAR> >;
+				fill[XOR] = fillRow<XOR, WordsAvx2<XOR> >;
+			}
+#endif
+		}
+	};
+}
+
+void fillSpans(unsigned char *row, int width, const int *spans, size_t count, Polarity_t polarity)
+{
+	static const Kernels kernels;
+	kernels.fill[polarity](row, width, spans, count);
+}
+
+void RowPainter::flush()
+{
+	size_t count = spans.size() / 2;
+	if (count == 0)
+		return;
+
+	// Resolve the row first when the spans draw over twice its width, and are long enough on average for
+	// drawing them to cost more than sorting them.
+	if (pixels > 2 * size_t(width) && pixels > minCoalescedLength * count)
+	{
+		runs.reset(width, isBlack);
+		for (size_t b = 0; b < batches.size(); b++)
+		{
+			size_t end = b + 1 < batches.size() ? batches[b + 1] : count;
+			for (size_t i = batches[b]; i < end; i++)
+				runs.draw(spans[2 * i], spans[2 * i + 1], polarities[b]);
+		}
+		const int *changes = runs.data();
+		size_t changeCount = runs.size();
+		spans.clear();
+		for (size_t i = 0; i < changeCount; i += 2)
+		{
+			spans.push_back(changes[i]);
+			spans.push_back(i + 1 < changeCount ? changes[i + 1] - 1 : width - 1);
+		}
+		memset(row, 0, (size_t(width) + 7) / 8);
+		fillSpans(row, width, spans.data(), spans.size() / 2, DARK);
+	}
+	else
+	{
+		for (size_t b = 0; b < batches.size(); b++)
+		{
+			size_t end = b + 1 < batches.size() ? batches[b + 1] : count;
+			fillSpans(row, width, &spans[2 * batches[b]], end - batches[b], polarities[b]);
+		}
+	}
+	spans.clear();
+	batches.clear();
+	polarities.clear();
+	pixels = 0;
+}
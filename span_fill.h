@@ -0,0 +1,66 @@
+// This file is distributed under the terms of the GNU General Public License v3.
+
+#ifndef SPAN_FILL_H_
+#define SPAN_FILL_H_
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "polygon.h"
+#include "row_runs.h"
+
+// Draws count spans on a row of a monochrome bitmap of 'width' pixels, most significant bit first: pixels
+// spans[2 * i] to spans[2 * i + 1], both included and in either order. DARK sets the pixels, CLEAR clears them
+// and XOR inverts them. Pixels outside the row are left out. The pixels are changed 64 at a time, and through
+// long spans 256 at a time on processors with AVX2.
+void fillSpans(unsigned char *row, int width, const int *spans, size_t count, Polarity_t polarity);
+
+/*
+ * RowPainter collects the spans drawn on a bitmap row and draws them once the row is done. Spans of one polarity
+ * drawn one after the other change the same pixels in any order, so each such batch takes a single fillSpans()
+ * call.
+ *
+ * Rows crossed by long overlapping spans, such as copper pours and grids at high resolutions, are resolved by a
+ * RowRuns first, so every pixel is written once: sorting the spans then costs less than drawing over the same
+ * pixels again and again.
+ */
+class RowPainter
+{
+private:
+	std::vector<int> spans;						// x1 and x2 of each span of the row
+	std::vector<size_t> batches;				// first span of each batch of one polarity
+	std::vector<Polarity_t> polarities;			// of each batch
+	size_t pixels;								// drawn by the spans, overlaps counted again
+	RowRuns runs;
+	unsigned char *row;
+	int width;
+	bool isBlack;
+
+public:
+	RowPainter() : pixels(0), row(0), width(0), isBlack(false) { }
+
+	// Starts drawing on a row of 'width' pixels, all black or white.
+	void begin(unsigned char *row, int width, bool isBlack)
+	{
+		this->row = row;
+		this->width = width;
+		this->isBlack = isBlack;
+	}
+
+	void draw(int x1, int x2, Polarity_t polarity)
+	{
+		if (polarities.empty() || polarities.back() != polarity)
+		{
+			batches.push_back(spans.size() / 2);
+			polarities.push_back(polarity);
+		}
+		spans.push_back(x1);
+		spans.push_back(x2);
+		pixels += size_t(std::abs(x2 - x1)) + 1;
+	}
+
+	void flush();								// draws the spans of the row
+};
+
+#endif // SPAN_FILL_H_